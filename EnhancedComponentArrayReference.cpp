@@ -0,0 +1,185 @@
+﻿/**
+ * @file EnhancedComponentArrayReference.cpp
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Implementation of the reference to several components of the same actor.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#include "Utilities/Property/EnhancedComponentArrayReference.h"
+
+#include "Utilities/Property/EnhancedComponentIndex.h"
+
+UEnhancedComponentArrayReference* UEnhancedComponentArrayReference::Create(
+	const TSubclassOf<UActorComponent> Type,
+	UObject* Owner,
+	const FName Name)
+{
+	if (!Type->IsValidLowLevel())
+	{
+		UE_LOG(
+			LogEnhancedComponentReference,
+			Warning,
+			TEXT("The type provided is invalid, check the UClass being provided."));
+		return nullptr;
+	}
+
+	if (Owner == nullptr)
+	{
+		UE_LOG(
+			LogEnhancedComponentReference,
+			Warning,
+			TEXT("The owner being provided is null"));
+		return nullptr;
+	}
+
+	FName ToAssign{Type->GetName() + TEXT("_ArrayRef")};
+	if (not Name.IsNone())
+	{
+		ToAssign = Name;
+	}
+
+	UEnhancedComponentArrayReference* Output{Owner->CreateDefaultSubobject<UEnhancedComponentArrayReference>(ToAssign)};
+	Output->Type = Type;
+
+	return Output;
+}
+
+#if WITH_EDITOR
+TArray<FString> UEnhancedComponentArrayReference::GetAvailableComponentNames() const
+{
+	// Same outers as the single references, the component (or its template) and then the actor or its class
+	const UClass* ActorClass{nullptr};
+	for (const UObject* Outer{GetOuter()}; Outer != nullptr; Outer = Outer->GetOuter())
+	{
+		if (const UClass* Class{Cast<UClass>(Outer)}; Class != nullptr)
+		{
+			ActorClass = Class->IsChildOf(AActor::StaticClass()) ? Class : nullptr;
+			break;
+		}
+
+		if (Outer->IsA<AActor>())
+		{
+			ActorClass = Outer->GetClass();
+			break;
+		}
+	}
+
+	if (ActorClass == nullptr || Type == nullptr)
+	{
+		UE_LOG(
+			LogEnhancedComponentReference,
+			Warning,
+			TEXT("%s is not declared on an actor or on one of its components"),
+			*GetPathName());
+		return {};
+	}
+
+	TArray<FString> Output{};
+	for (const FEnhancedComponentSlot& Slot : FEnhancedComponentIndex::Get(*ActorClass)->GetSlots())
+	{
+		if (const UClass* ComponentClass{Slot.ComponentClass.Get()};
+			ComponentClass != nullptr && ComponentClass->IsChildOf(Type))
+		{
+			Output.Push(Slot.Name.ToString());
+		}
+	}
+
+	return Output;
+}
+#endif
+
+TConstArrayView<UActorComponent*> UEnhancedComponentArrayReference::GetComponents(const UObject& InstancedObject) const
+{
+	const AActor* Actor{Cast<AActor>(&InstancedObject)};
+	if (const UActorComponent* Component{Cast<UActorComponent>(&InstancedObject)}; Component != nullptr)
+	{
+		Actor = Component->GetOwner();
+	}
+
+	if (Actor == nullptr || Type == nullptr)
+	{
+		UE_LOG(
+			LogEnhancedComponentReference,
+			Warning,
+			TEXT("There is no valid owner or type to get the components"));
+		return {};
+	}
+
+	if (!IsUpToDate(*Actor))
+	{
+		Rebuild(*Actor);
+	}
+
+	return ComponentsView;
+}
+
+bool UEnhancedComponentArrayReference::IsUpToDate(const AActor& Actor) const
+{
+	if (CachedActor.Get() != &Actor)
+	{
+		return false;
+	}
+
+	// The weak pointers catch the components that got destroyed (or garbage collected) since they were resolved
+	for (int32 Index{0}; Index < CachedComponents.Num(); ++Index)
+	{
+		if (CachedComponents[Index].Get() != ComponentsView[Index] || ComponentsView[Index]->GetOwner() != &Actor)
+		{
+			return false;
+		}
+	}
+
+	// A rerun of the construction script destroys the referenced components, so the weak pointers already caught it.
+	// What's left are components added to the actor, which might match the names or the pattern
+	return Actor.GetComponents().Num() == CachedComponentCount;
+}
+
+void UEnhancedComponentArrayReference::Invalidate()
+{
+	CachedActor.Reset();
+}
+
+void UEnhancedComponentArrayReference::Rebuild(const AActor& Actor) const
+{
+	CachedActor = &Actor;
+	ComponentsView.Reset();
+	CachedComponentCount = Actor.GetComponents().Num();
+
+	// Going through the set once covers the C++, Blueprint and instance components, and anything added at runtime
+	TArray<UActorComponent*> PatternMatches{};
+	for (UActorComponent* Component : Actor.GetComponents())
+	{
+		if (!IsValid(Component) || !Component->IsA(Type))
+		{
+			continue;
+		}
+
+		if (ComponentNames.Contains(Component->GetFName()))
+		{
+			ComponentsView.Push(Component);
+		}
+		else if (!Pattern.IsEmpty() && Component->GetName().MatchesWildcard(Pattern))
+		{
+			PatternMatches.Push(Component);
+		}
+	}
+
+	// The named components keep the order they were picked in, the set itself has no meaningful order
+	ComponentsView.Sort([this](const UActorComponent& Lhs, const UActorComponent& Rhs)
+	{
+		return ComponentNames.IndexOfByKey(Lhs.GetFName()) < ComponentNames.IndexOfByKey(Rhs.GetFName());
+	});
+	PatternMatches.Sort([](const UActorComponent& Lhs, const UActorComponent& Rhs)
+	{
+		return Lhs.GetFName().LexicalLess(Rhs.GetFName());
+	});
+	ComponentsView.Append(MoveTemp(PatternMatches));
+
+	CachedComponents.Reset(ComponentsView.Num());
+	for (UActorComponent* Component : ComponentsView)
+	{
+		CachedComponents.Emplace(Component);
+	}
+}
@@ -0,0 +1,149 @@
+﻿/**
+ * @file EnhancedComponentArrayReference.h
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Reference to several components of the same actor (e.g. every hitbox shape), picked by name or by a pattern.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Utilities/Property/EnhancedComponentReference.h"
+#include "EnhancedComponentArrayReference.generated.h"
+
+/**
+ * @brief Type to refer to a group of components in the same actor.
+ * The components are resolved once and kept as a contiguous view. Getting them again only checks the resolved components
+ * and the number of components of the actor, so gameplay code can get and go through them every frame.
+ */
+UCLASS()
+class IDOLONDUTY_API UEnhancedComponentArrayReference : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * @brief Factory method for an enhanced array reference (CONSTRUCTOR ONLY)
+	 * @param Type The type of the components
+	 * @param Owner The owner of this reference (almost always it should be this)
+	 * @param Name The name of the reference in the editor
+	 * @return Pointer to the new reference
+	 */
+	UFUNCTION()
+	[[nodiscard]] static UEnhancedComponentArrayReference* Create(
+		const TSubclassOf<UActorComponent> Type,
+		UObject* Owner,
+		const FName Name = "");
+
+	/**
+	 * @brief Factory method for an enhanced array reference (CONSTRUCTOR ONLY)
+	 * @tparam T The type of the components
+	 * @param Owner The owner of this reference (almost always it should be this)
+	 * @return Pointer to the new reference
+	 */
+	template <ComponentClass T>
+	[[nodiscard]] static UEnhancedComponentArrayReference* Create(UObject& Owner, const FName Name = "");
+
+	/**
+	 * Names of the components, these come first in the view and in this order
+	 */
+	UPROPERTY(EditAnywhere, meta=(GetOptions="GetAvailableComponentNames"))
+	TArray<FName> ComponentNames;
+
+	/**
+	 * Wildcard pattern (e.g. "Hitbox_*") for the components to add after the ones in ComponentNames, empty to only use
+	 * the names
+	 */
+	UPROPERTY(EditAnywhere)
+	FString Pattern;
+
+	UPROPERTY(VisibleAnywhere)
+	TSubclassOf<UActorComponent> Type;
+
+#if WITH_EDITOR
+	/**
+	 * @brief Options for the entries of ComponentNames, the components of the owner class of the type.
+	 */
+	UFUNCTION()
+	[[nodiscard]] TArray<FString> GetAvailableComponentNames() const;
+#endif
+
+	/**
+	 * @brief Gets the components that have been referenced. Once resolved this costs a check of each referenced
+	 * component and of the number of components of the owner, the view is only rebuilt when those change.
+	 * @param InstancedObject The owner that we should be fetching from (the actor or one of its components)
+	 * @return View of the components, valid until the next call
+	 */
+	[[nodiscard]] TConstArrayView<UActorComponent*> GetComponents(const UObject& InstancedObject) const;
+
+	/**
+	 * @brief Gets the components that have been referenced.
+	 * @tparam T The type of the reference or one of its parents
+	 * @param InstancedObject The owner that we should be fetching from (the actor or one of its components)
+	 * @return View of the components, valid until the next call
+	 */
+	template <ComponentClass T>
+	[[nodiscard]] TConstArrayView<T*> GetComponents(const UObject& InstancedObject) const;
+
+	/**
+	 * @brief Makes the next get resolve the components again, for when a component matching the reference gets added
+	 * in the same frame as another one of the owner gets destroyed (which the cheap check can't tell).
+	 */
+	void Invalidate();
+
+private:
+	/**
+	 * @brief Resolves the components again, the named ones first and then the ones matching the pattern.
+	 */
+	void Rebuild(const AActor& Actor) const;
+
+	/**
+	 * @brief Checks that the cached components are still alive and on the actor, and that the actor has as many
+	 * components as when they got resolved.
+	 */
+	[[nodiscard]] bool IsUpToDate(const AActor& Actor) const;
+
+	/** Actor the cached components were resolved against */
+	mutable TWeakObjectPtr<const AActor> CachedActor;
+
+	/** The components that were resolved, these are what tells if the ones behind the views are still alive */
+	mutable TArray<TWeakObjectPtr<UActorComponent>> CachedComponents;
+
+	/** Same components as CachedComponents, these are the ones behind the views and only get read once validated */
+	mutable TArray<UActorComponent*> ComponentsView;
+
+	/** Number of components of the cached actor when the components got resolved */
+	mutable int32 CachedComponentCount{0};
+};
+
+template <ComponentClass T>
+UEnhancedComponentArrayReference* UEnhancedComponentArrayReference::Create(UObject& Owner, const FName Name)
+{
+	FName ToAssign{T::StaticClass()->GetName() + TEXT("_ArrayRef")};
+	if (not Name.IsNone())
+	{
+		ToAssign = Name;
+	}
+
+	UEnhancedComponentArrayReference* Output{Owner.CreateDefaultSubobject<UEnhancedComponentArrayReference>(ToAssign)};
+	Output->Type = T::StaticClass();
+
+	return Output;
+}
+
+template <ComponentClass T>
+TConstArrayView<T*> UEnhancedComponentArrayReference::GetComponents(const UObject& InstancedObject) const
+{
+	// Every component in the view is of the type, so the pointers can be handed out as the type directly
+	if (!ensureMsgf(Type != nullptr && Type->IsChildOf(T::StaticClass()), TEXT("%s is not of type %s"),
+	                *GetPathName(), *T::StaticClass()->GetName()))
+	{
+		return {};
+	}
+
+	const TConstArrayView<UActorComponent*> Components{GetComponents(InstancedObject)};
+	return MakeArrayView(reinterpret_cast<T* const*>(Components.GetData()), Components.Num());
+}
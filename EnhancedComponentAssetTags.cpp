@@ -0,0 +1,165 @@
+﻿/**
+ * @file EnhancedComponentAssetTags.cpp
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Implementation of the asset registry tags for the enhanced component references.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#include "Utilities/Property/EnhancedComponentAssetTags.h"
+
+#include "Utilities/Property/EnhancedComponentReference.h"
+#include "AssetRegistry/AssetData.h"
+#include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "UObject/AssetRegistryTagsContext.h"
+#include "UObject/UObjectHash.h"
+
+const FName FEnhancedComponentAssetTags::ReferencesTag{TEXT("EnhancedComponentReferences")};
+const FName FEnhancedComponentAssetTags::ReferenceCountTag{TEXT("EnhancedComponentReferenceCount")};
+
+namespace
+{
+	// Separators of the tag value: entries are split by the first one, their fields by the second one
+	constexpr TCHAR EntrySeparator{TEXT(';')};
+	constexpr TCHAR FieldSeparator{TEXT('|')};
+
+#if WITH_EDITOR
+	// Blueprints don't give anyone a say in their tags, so they are added from the hook every save goes through
+	FDelayedAutoRegisterHelper RegisterTags{
+		EDelayedRegisterRunPhase::ObjectSystemReady,
+		[]
+		{
+			UObject::FAssetRegistryTag::OnGetExtraObjectTagsWithContext.AddLambda(
+				[](FAssetRegistryTagsContext Context)
+				{
+					const UObject* Object{Context.GetObject()};
+					if (Object != nullptr && (Object->IsA<UBlueprint>() || Object->IsA<UBlueprintGeneratedClass>()))
+					{
+						FEnhancedComponentAssetTags::AppendTags(*Object, Context);
+					}
+				});
+		}
+	};
+#endif
+}
+
+void FEnhancedComponentAssetTags::AppendTags(const UObject& Asset, FAssetRegistryTagsContext Context)
+{
+	const UClass* OwnerClass{Cast<UClass>(&Asset)};
+	if (const UBlueprint* Blueprint{Cast<UBlueprint>(&Asset)}; Blueprint != nullptr)
+	{
+		OwnerClass = Blueprint->GeneratedClass;
+	}
+
+	TArray<FString> Entries{};
+	const auto AddEntry{
+		[&Entries](const UEnhancedComponentReference& Reference)
+		{
+			FString Entry{Reference.GetOuter()->GetName()};
+			Entry.AppendChar(FieldSeparator);
+			Entry += Reference.GetName();
+			Entry.AppendChar(FieldSeparator);
+			Entry += Reference.SoftType.IsNull()
+				         ? FSoftClassPath{Reference.Type.Get()}.ToString()
+				         : Reference.SoftType.ToString();
+			Entry.AppendChar(FieldSeparator);
+			Entry += Reference.ComponentName.ToString();
+			Entry.AppendChar(FieldSeparator);
+			Entry += Reference.bUseOtherAsset ? TEXT("1") : TEXT("0");
+			Entry.AppendChar(FieldSeparator);
+			Entry += Reference.bUseOtherAsset ? Reference.ProvidedArchetype.ToString() : FString{};
+			Entry.AppendChar(FieldSeparator);
+			Entry += Reference.SoftType.IsNull() ? TEXT("0") : TEXT("1");
+			Entry.AppendChar(FieldSeparator);
+			Entry += Reference.InterfaceType != nullptr ? FSoftClassPath{Reference.InterfaceType.Get()}.ToString() : FString{};
+
+			Entries.Push(MoveTemp(Entry));
+		}
+	};
+
+	if (OwnerClass != nullptr)
+	{
+		UEnhancedComponentReference::ForEachDeclaredReference(*OwnerClass, AddEntry);
+	}
+	else
+	{
+		// Any other asset only has the references that are its own subobjects
+		ForEachObjectWithOuter(&Asset, [&AddEntry](UObject* Object)
+		{
+			if (const UEnhancedComponentReference* Reference{Cast<UEnhancedComponentReference>(Object)}; Reference != nullptr)
+			{
+				AddEntry(*Reference);
+			}
+		});
+	}
+
+	if (Entries.IsEmpty())
+	{
+		return;
+	}
+
+	// Sorting keeps the tag the same between saves when nothing changed
+	Entries.Sort();
+
+	Context.AddTag(UObject::FAssetRegistryTag{
+		ReferencesTag,
+		FString::Join(Entries, *FString::Chr(EntrySeparator)),
+		UObject::FAssetRegistryTag::TT_Hidden
+	});
+	Context.AddTag(UObject::FAssetRegistryTag{
+		ReferenceCountTag,
+		FString::FromInt(Entries.Num()),
+		UObject::FAssetRegistryTag::TT_Numerical
+	});
+}
+
+TArray<FEnhancedComponentReferenceTag> FEnhancedComponentAssetTags::Parse(const FAssetData& AssetData)
+{
+	FString Value{};
+	if (!AssetData.GetTagValue(ReferencesTag, Value))
+	{
+		return {};
+	}
+
+	TArray<FString> Entries{};
+	Value.ParseIntoArray(Entries, *FString::Chr(EntrySeparator));
+
+	TArray<FEnhancedComponentReferenceTag> Output{};
+	Output.Reserve(Entries.Num());
+
+	for (const FString& Entry : Entries)
+	{
+		TArray<FString> Fields{};
+		Entry.ParseIntoArray(Fields, *FString::Chr(FieldSeparator), false);
+		if (Fields.Num() < 6)
+		{
+			UE_LOG(
+				LogEnhancedComponentReference,
+				Warning,
+				TEXT("Malformed reference tag in %s: %s"),
+				*AssetData.GetObjectPathString(),
+				*Entry);
+			continue;
+		}
+
+		FEnhancedComponentReferenceTag& Tag{Output.AddDefaulted_GetRef()};
+		Tag.Owner = Fields[0];
+		Tag.Reference = *Fields[1];
+		Tag.Type = FSoftClassPath{Fields[2]};
+		Tag.ComponentName = *Fields[3];
+		Tag.bUseOtherAsset = Fields[4] == TEXT("1");
+		Tag.ProvidedArchetype = FSoftClassPath{Fields[5]};
+
+		// Assets saved before the soft types existed don't have the field
+		Tag.bSoftType = Fields.IsValidIndex(6) && Fields[6] == TEXT("1");
+		if (Fields.IsValidIndex(7))
+		{
+			Tag.InterfaceType = FSoftClassPath{Fields[7]};
+		}
+	}
+
+	return Output;
+}
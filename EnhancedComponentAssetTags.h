@@ -0,0 +1,70 @@
+﻿/**
+ * @file EnhancedComponentAssetTags.h
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Asset registry tags listing the enhanced component references declared by an asset, so that tools can find
+ * every reference in the project without loading the packages.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+
+class FAssetRegistryTagsContext;
+struct FAssetData;
+
+/**
+ * @brief A reference as it is described by the tags of its asset.
+ */
+struct FEnhancedComponentReferenceTag
+{
+	/** Name of the object declaring the reference (component template or CDO) */
+	FString Owner;
+
+	/** Name of the reference subobject */
+	FName Reference;
+
+	FSoftClassPath Type;
+
+	/** Whether the type is only loaded on demand (see UEnhancedComponentReference::CreateSoft) */
+	bool bSoftType{false};
+
+	/** Interface the component has to implement, empty for most references */
+	FSoftClassPath InterfaceType;
+
+	FName ComponentName;
+
+	bool bUseOtherAsset{false};
+
+	/** Only set when bUseOtherAsset is */
+	FSoftClassPath ProvidedArchetype;
+};
+
+/**
+ * @brief Writes and reads the reference tags of the assets.
+ */
+class IDOLONDUTY_API FEnhancedComponentAssetTags
+{
+public:
+	/** Tag with the description of every reference of the asset */
+	static const FName ReferencesTag;
+
+	/** Tag with the amount of references of the asset, meant for filtering */
+	static const FName ReferenceCountTag;
+
+	/**
+	 * @brief Adds the tags for the references declared by the asset. Blueprints get these automatically, other assets
+	 * owning references can call this from their GetAssetRegistryTags.
+	 * @param Asset The asset being saved (a Blueprint, its generated class or any object declaring references)
+	 * @param Context The context of the tags being gathered
+	 */
+	static void AppendTags(const UObject& Asset, FAssetRegistryTagsContext Context);
+
+	/**
+	 * @brief Reads the references described by the tags of an asset without loading it.
+	 */
+	[[nodiscard]] static TArray<FEnhancedComponentReferenceTag> Parse(const FAssetData& AssetData);
+};
@@ -0,0 +1,431 @@
+﻿/**
+ * @file EnhancedComponentAuditCommandlet.cpp
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Implementation of the commandlet auditing the enhanced component references of the project.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#include "Utilities/Property/EnhancedComponentAuditCommandlet.h"
+
+#include "Utilities/Property/EnhancedComponentAssetTags.h"
+#include "Utilities/Property/EnhancedComponentIndex.h"
+#include "Utilities/Property/EnhancedComponentReference.h"
+#include "Utilities/Property/EnhancedComponentResolutionPlan.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Components/ChildActorComponent.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/SCS_Node.h"
+#include "Engine/SimpleConstructionScript.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/UObjectIterator.h"
+
+namespace
+{
+	constexpr int32 DefaultBatchSize{64};
+
+	/**
+	 * @brief Rough amount of components that the step visits to get to the component.
+	 */
+	int32 EstimateCost(const EEnhancedComponentPlanStep Step, const int32 ComponentCount)
+	{
+		switch (Step)
+		{
+		case EEnhancedComponentPlanStep::ReadProperty:
+		case EEnhancedComponentPlanStep::BlueprintIndex:
+		case EEnhancedComponentPlanStep::TypeMismatch:
+			return 1;
+
+		case EEnhancedComponentPlanStep::FindSubobject:
+			return 2;
+
+		case EEnhancedComponentPlanStep::Scan:
+			// Both the C++ and the Blueprint lists get gone through before giving up
+			return FMath::Max(ComponentCount, 1);
+		}
+
+		return 0;
+	}
+
+	FString EscapeCsv(const FString& Value)
+	{
+		if (!Value.Contains(TEXT(",")) && !Value.Contains(TEXT("\"")))
+		{
+			return Value;
+		}
+
+		return TEXT("\"") + Value.Replace(TEXT("\""), TEXT("\"\"")) + TEXT("\"");
+	}
+}
+
+UEnhancedComponentAuditCommandlet::UEnhancedComponentAuditCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UEnhancedComponentAuditCommandlet::Main(const FString& Params)
+{
+	FString Format{TEXT("json")};
+	FParse::Value(*Params, TEXT("Format="), Format);
+
+	FString ReportFile{
+		FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("EnhancedComponentReference"), TEXT("Audit.") + Format)
+	};
+	FParse::Value(*Params, TEXT("Report="), ReportFile);
+
+	int32 BatchSize{DefaultBatchSize};
+	FParse::Value(*Params, TEXT("BatchSize="), BatchSize);
+	BatchSize = FMath::Max(BatchSize, 1);
+
+	const bool bAllBlueprints{FParse::Param(*Params, TEXT("All"))};
+	const bool bNoFail{FParse::Param(*Params, TEXT("NoFail"))};
+
+	IAssetRegistry& AssetRegistry{FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get()};
+	AssetRegistry.SearchAllAssets(true);
+
+	FARFilter Filter{};
+	Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+
+	// The tags know which Blueprints have references, -All is only needed for assets saved before the tags existed
+	if (!bAllBlueprints)
+	{
+		Filter.TagsAndValues.Add(FEnhancedComponentAssetTags::ReferenceCountTag, TOptional<FString>{});
+	}
+
+	TArray<FAssetData> Assets{};
+	AssetRegistry.GetAssets(Filter, Assets);
+	Assets.Sort([](const FAssetData& Lhs, const FAssetData& Rhs) { return Lhs.PackageName.LexicalLess(Rhs.PackageName); });
+
+	UE_LOG(LogEnhancedComponentReference, Display, TEXT("Auditing %d Blueprints"), Assets.Num());
+
+	for (int32 BatchStart{0}; BatchStart < Assets.Num(); BatchStart += BatchSize)
+	{
+		const int32 BatchEnd{FMath::Min(BatchStart + BatchSize, Assets.Num())};
+
+		// The whole batch is requested at once so the async loader can work on the packages in parallel
+		for (int32 Index{BatchStart}; Index < BatchEnd; ++Index)
+		{
+			LoadPackageAsync(Assets[Index].PackageName.ToString());
+		}
+		FlushAsyncLoading();
+
+		for (int32 Index{BatchStart}; Index < BatchEnd; ++Index)
+		{
+			const UBlueprint* Blueprint{Cast<UBlueprint>(Assets[Index].FastGetAsset(false))};
+			if (Blueprint == nullptr || Blueprint->GeneratedClass == nullptr)
+			{
+				continue;
+			}
+
+			AuditClass(Assets[Index].GetObjectPathString(), *Blueprint->GeneratedClass);
+		}
+
+		// Keeping every Blueprint of the project loaded at once doesn't fit on the build machines
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+		UE_LOG(LogEnhancedComponentReference, Display, TEXT("Audited %d/%d Blueprints"), BatchEnd, Assets.Num());
+	}
+
+	// The C++ classes don't have assets, their references only get a name in C++ when they are meant to be used as is
+	// (the rest get theirs in the Blueprints, which were audited above)
+	int32 NativeCount{0};
+	for (TObjectIterator<UClass> It{}; It; ++It)
+	{
+		if (!It->HasAnyClassFlags(CLASS_Native) || !It->IsChildOf(AActor::StaticClass()))
+		{
+			continue;
+		}
+
+		UEnhancedComponentReference::ForEachDeclaredReference(**It, [&](const UEnhancedComponentReference& Reference)
+		{
+			if (!Reference.ComponentName.IsNone())
+			{
+				AuditReference(It->GetPathName(), **It, Reference);
+				++NativeCount;
+			}
+		});
+	}
+
+	UE_LOG(LogEnhancedComponentReference, Display, TEXT("Audited %d references of C++ classes"), NativeCount);
+
+	const FString Report{Format == TEXT("csv") ? ToCsv() : ToJson()};
+	if (!FFileHelper::SaveStringToFile(Report, *ReportFile))
+	{
+		UE_LOG(LogEnhancedComponentReference, Error, TEXT("Could not write %s"), *ReportFile);
+		return 1;
+	}
+
+	if (FString ManifestFile{};
+		FParse::Value(*Params, TEXT("Manifest="), ManifestFile) || FParse::Param(*Params, TEXT("Manifest")))
+	{
+		if (ManifestFile.IsEmpty())
+		{
+			ManifestFile = FEnhancedComponentManifest::GetDefaultPath();
+		}
+
+		if (!FEnhancedComponentManifest::Write(ManifestFile, ManifestEntries))
+		{
+			UE_LOG(LogEnhancedComponentReference, Error, TEXT("Could not write %s"), *ManifestFile);
+			return 1;
+		}
+
+		UE_LOG(
+			LogEnhancedComponentReference,
+			Display,
+			TEXT("Wrote %d plans to the manifest %s"),
+			ManifestEntries.Num(),
+			*ManifestFile);
+	}
+
+	int32 BrokenCount{0};
+	int32 ScanCount{0};
+	for (const FReferenceEntry& Entry : References)
+	{
+		BrokenCount += Entry.bBroken;
+		ScanCount += Entry.Step == TEXT("Scan");
+	}
+
+	UE_LOG(
+		LogEnhancedComponentReference,
+		Display,
+		TEXT("%d references, %d broken, %d needing a scan, %d duplicated names. Report written to %s"),
+		References.Num(),
+		BrokenCount,
+		ScanCount,
+		Duplicates.Num(),
+		*ReportFile);
+
+	return BrokenCount > 0 && !bNoFail ? 1 : 0;
+}
+
+void UEnhancedComponentAuditCommandlet::AuditClass(const FString& Asset, const UClass& ActorClass)
+{
+	UEnhancedComponentReference::ForEachDeclaredReference(ActorClass, [&](const UEnhancedComponentReference& Reference)
+	{
+		AuditReference(Asset, ActorClass, Reference);
+	});
+
+	if (!ActorClass.IsChildOf(AActor::StaticClass()))
+	{
+		return;
+	}
+
+	// The index keeps the first component with a name, so the duplicates have to be looked for in the sources
+	TSet<FName> NativeNames{};
+	if (const AActor* DefaultActor{Cast<AActor>(ActorClass.GetDefaultObject(false))}; DefaultActor != nullptr)
+	{
+		TArray<UActorComponent*> Components{};
+		DefaultActor->GetComponents(Components);
+		for (const UActorComponent* Component : Components)
+		{
+			NativeNames.Add(Component->GetFName());
+		}
+	}
+
+	for (const UBlueprintGeneratedClass* BPClass : FEnhancedComponentIndex::GetBlueprintHierarchy(ActorClass))
+	{
+		if (BPClass->SimpleConstructionScript == nullptr)
+		{
+			continue;
+		}
+
+		for (const USCS_Node* Node : BPClass->SimpleConstructionScript->GetAllNodes())
+		{
+			if (NativeNames.Contains(Node->GetVariableName()))
+			{
+				Duplicates.Push({Asset, Node->GetVariableName().ToString()});
+			}
+		}
+	}
+}
+
+void UEnhancedComponentAuditCommandlet::AuditReference(
+	const FString& Asset,
+	const UClass& ActorClass,
+	const UEnhancedComponentReference& Reference)
+{
+	FReferenceEntry& Entry{References.AddDefaulted_GetRef()};
+	Entry.Asset = Asset;
+	Entry.Owner = Reference.GetOuter()->GetName();
+	Entry.Reference = Reference.GetName();
+	UClass* ReferenceType{Reference.LoadType()};
+	Entry.Type = ReferenceType != nullptr ? ReferenceType->GetPathName() : TEXT("None");
+	if (const UClass* Interface{Reference.InterfaceType.Get()}; Interface != nullptr)
+	{
+		Entry.Type += TEXT(" & ") + Interface->GetPathName();
+	}
+	Entry.ComponentName = Reference.ComponentName.ToString();
+
+	// The archetype is a soft reference, the commandlet can afford loading it
+	const UClass* Target{Reference.bUseOtherAsset ? Reference.ProvidedArchetype.LoadSynchronous() : &ActorClass};
+	Entry.Target = Target != nullptr ? Target->GetPathName() : TEXT("None");
+
+	if (ReferenceType == nullptr)
+	{
+		Entry.Issue = Reference.SoftType.IsNull() ? TEXT("Type is not set") : TEXT("SoftType could not be loaded");
+		Entry.bBroken = true;
+		return;
+	}
+
+	if (Reference.ComponentName.IsNone())
+	{
+		Entry.Issue = TEXT("ComponentName is not set");
+		Entry.bBroken = true;
+		return;
+	}
+
+	if (Target == nullptr)
+	{
+		Entry.Issue = Reference.ProvidedArchetype.IsNull()
+			              ? TEXT("ProvidedArchetype is not set")
+			              : TEXT("ProvidedArchetype could not be loaded");
+		Entry.bBroken = true;
+		return;
+	}
+
+	if (!Target->IsChildOf(AActor::StaticClass()))
+	{
+		// References declared on component Blueprints only know their actor once the component is added to one
+		Entry.Issue = TEXT("Not declared on an actor, resolved against the actors using the component");
+		Entry.Step = TEXT("Unknown");
+		return;
+	}
+
+	// Paths into child actors get checked against the class of the child actor
+	FName ComponentName{Reference.ComponentName};
+	if (FName ChildActorName{}, InnerName{};
+		UEnhancedComponentReference::SplitChildActorPath(ComponentName, ChildActorName, InnerName))
+	{
+		const FEnhancedComponentSlot* Slot{FEnhancedComponentIndex::Get(*Target)->Find(ChildActorName)};
+		const UChildActorComponent* ChildActorTemplate{
+			Slot != nullptr ? Cast<UChildActorComponent>(Slot->Template.Get()) : nullptr
+		};
+		const UClass* ChildActorClass{
+			ChildActorTemplate != nullptr ? ChildActorTemplate->GetChildActorClass().Get() : nullptr
+		};
+		if (ChildActorClass == nullptr)
+		{
+			Entry.Issue = TEXT("The child actor component doesn't exist or doesn't have a child actor class");
+			Entry.bBroken = true;
+			return;
+		}
+
+		Target = ChildActorClass;
+		ComponentName = InnerName;
+	}
+
+	const FEnhancedComponentResolutionPlan Plan{
+		FEnhancedComponentPlanCache::Compile(*Target, ComponentName, ReferenceType)
+	};
+	Entry.Step = FEnhancedComponentPlanCache::LexToString(Plan.Step);
+	ManifestEntries.Push(FEnhancedComponentManifest::MakeEntry(*Target, ComponentName, ReferenceType, Plan));
+	Entry.EstimatedCost = EstimateCost(Plan.Step, FEnhancedComponentIndex::Get(*Target)->GetSlots().Num());
+
+	if (Plan.Step == EEnhancedComponentPlanStep::TypeMismatch)
+	{
+		Entry.Issue = TEXT("The component is not of the Type of the reference");
+		Entry.bBroken = true;
+	}
+	else if (const UClass* ComponentClass{Plan.Slot.ComponentClass.Get()};
+		Plan.Step != EEnhancedComponentPlanStep::Scan && Reference.InterfaceType != nullptr && ComponentClass != nullptr
+		&& !ComponentClass->ImplementsInterface(Reference.InterfaceType))
+	{
+		Entry.Issue = TEXT("The component doesn't implement the InterfaceType of the reference");
+		Entry.bBroken = true;
+	}
+	else if (Plan.Step == EEnhancedComponentPlanStep::Scan && Reference.bAddedAtRuntime)
+	{
+		Entry.Issue = TEXT("The component is not part of the class, it will only be found if it is created at runtime");
+	}
+	else if (Plan.Step == EEnhancedComponentPlanStep::Scan)
+	{
+		// Almost always a typo or a component that got renamed or deleted
+		Entry.Issue = TEXT("No component of the class has the ComponentName (set bAddedAtRuntime if it is created at runtime)");
+		Entry.bBroken = true;
+	}
+}
+
+FString UEnhancedComponentAuditCommandlet::ToJson() const
+{
+	TArray<TSharedPtr<FJsonValue>> ReferenceValues{};
+	for (const FReferenceEntry& Entry : References)
+	{
+		const TSharedRef<FJsonObject> Object{MakeShared<FJsonObject>()};
+		Object->SetStringField(TEXT("asset"), Entry.Asset);
+		Object->SetStringField(TEXT("owner"), Entry.Owner);
+		Object->SetStringField(TEXT("reference"), Entry.Reference);
+		Object->SetStringField(TEXT("type"), Entry.Type);
+		Object->SetStringField(TEXT("componentName"), Entry.ComponentName);
+		Object->SetStringField(TEXT("target"), Entry.Target);
+		Object->SetStringField(TEXT("step"), Entry.Step);
+		Object->SetStringField(TEXT("issue"), Entry.Issue);
+		Object->SetBoolField(TEXT("broken"), Entry.bBroken);
+		Object->SetNumberField(TEXT("estimatedCost"), Entry.EstimatedCost);
+		ReferenceValues.Push(MakeShared<FJsonValueObject>(Object));
+	}
+
+	TArray<TSharedPtr<FJsonValue>> DuplicateValues{};
+	for (const FDuplicateEntry& Entry : Duplicates)
+	{
+		const TSharedRef<FJsonObject> Object{MakeShared<FJsonObject>()};
+		Object->SetStringField(TEXT("asset"), Entry.Asset);
+		Object->SetStringField(TEXT("componentName"), Entry.ComponentName);
+		DuplicateValues.Push(MakeShared<FJsonValueObject>(Object));
+	}
+
+	const TSharedRef<FJsonObject> Root{MakeShared<FJsonObject>()};
+	Root->SetArrayField(TEXT("references"), ReferenceValues);
+	Root->SetArrayField(TEXT("duplicates"), DuplicateValues);
+
+	FString Output{};
+	const TSharedRef<TJsonWriter<>> Writer{TJsonWriterFactory<>::Create(&Output)};
+	FJsonSerializer::Serialize(Root, Writer);
+
+	return Output;
+}
+
+FString UEnhancedComponentAuditCommandlet::ToCsv() const
+{
+	FString Output{TEXT("Kind,Asset,Owner,Reference,Type,ComponentName,Target,Step,Issue,Broken,EstimatedCost\n")};
+
+	for (const FReferenceEntry& Entry : References)
+	{
+		Output += FString::Join(
+			TArray<FString>{
+				TEXT("Reference"),
+				EscapeCsv(Entry.Asset),
+				EscapeCsv(Entry.Owner),
+				EscapeCsv(Entry.Reference),
+				EscapeCsv(Entry.Type),
+				EscapeCsv(Entry.ComponentName),
+				EscapeCsv(Entry.Target),
+				Entry.Step,
+				EscapeCsv(Entry.Issue),
+				Entry.bBroken ? TEXT("1") : TEXT("0"),
+				FString::FromInt(Entry.EstimatedCost)
+			},
+			TEXT(","));
+		Output += TEXT("\n");
+	}
+
+	for (const FDuplicateEntry& Entry : Duplicates)
+	{
+		Output += FString::Printf(
+			TEXT("Duplicate,%s,,,,%s,,,,0,0\n"),
+			*EscapeCsv(Entry.Asset),
+			*EscapeCsv(Entry.ComponentName));
+	}
+
+	return Output;
+}
@@ -0,0 +1,87 @@
+﻿/**
+ * @file EnhancedComponentAuditCommandlet.h
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Commandlet validating every enhanced component reference of the project against its archetype, and
+ * estimating how expensive each one is to resolve. Meant to run headless on the build machines.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=EnhancedComponentAudit -nullrhi [-Report=<File>] [-Format=json|csv]
+ *        [-BatchSize=64] [-All] [-NoFail] [-Manifest[=<File>]]
+ *
+ * With -Manifest the plans of every reference also get written to the binary manifest loaded by the cooked builds,
+ * this is meant to run as part of the cook.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Utilities/Property/EnhancedComponentManifest.h"
+#include "EnhancedComponentAuditCommandlet.generated.h"
+
+class UEnhancedComponentReference;
+
+/**
+ * @brief Writes a report of the broken references, the ones needing the slow scan and the duplicated names.
+ *
+ * This covers the references of the Blueprints and of the C++ actor classes. The references of the actors placed in
+ * the maps aren't audited, loading every map is too much for the build machines.
+ */
+UCLASS()
+class IDOLONDUTY_API UEnhancedComponentAuditCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UEnhancedComponentAuditCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/**
+	 * @brief Result of validating a single reference.
+	 */
+	struct FReferenceEntry
+	{
+		FString Asset;
+		FString Owner;
+		FString Reference;
+		FString Type;
+		FString ComponentName;
+		FString Target;
+		FString Step;
+
+		/** Empty when the reference resolves without problems */
+		FString Issue;
+
+		/** Whether the issue means that the reference will never resolve */
+		bool bBroken{false};
+
+		/** Rough amount of component visits needed to resolve the reference */
+		int32 EstimatedCost{0};
+	};
+
+	/**
+	 * @brief A name used both by a C++ component and by a Blueprint component of the same class.
+	 */
+	struct FDuplicateEntry
+	{
+		FString Asset;
+		FString ComponentName;
+	};
+
+	void AuditClass(const FString& Asset, const UClass& ActorClass);
+
+	void AuditReference(const FString& Asset, const UClass& ActorClass, const UEnhancedComponentReference& Reference);
+
+	[[nodiscard]] FString ToJson() const;
+	[[nodiscard]] FString ToCsv() const;
+
+	TArray<FReferenceEntry> References;
+	TArray<FDuplicateEntry> Duplicates;
+
+	/** Plans of the references that resolve, for the cooked manifest */
+	TArray<FEnhancedComponentManifestEntry> ManifestEntries;
+};
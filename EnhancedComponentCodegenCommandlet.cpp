@@ -0,0 +1,218 @@
+﻿/**
+ * @file EnhancedComponentCodegenCommandlet.cpp
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Implementation of the commandlet generating constant slot accessors for the enhanced component references.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#include "Utilities/Property/EnhancedComponentCodegenCommandlet.h"
+
+#include "Utilities/Property/EnhancedComponentReference.h"
+#include "Utilities/Property/EnhancedComponentResolutionPlan.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UEnhancedComponentCodegenCommandlet::UEnhancedComponentCodegenCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UEnhancedComponentCodegenCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString SearchPath{TEXT("/Game")};
+	FParse::Value(*Params, TEXT("Path="), SearchPath);
+
+	FString OutputFile{
+		FPaths::Combine(FPaths::GameSourceDir(), FApp::GetProjectName(), TEXT("Generated"), TEXT("EnhancedComponentSlots.h"))
+	};
+	FParse::Value(*Params, TEXT("Output="), OutputFile);
+
+	IAssetRegistry& AssetRegistry{FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get()};
+	AssetRegistry.SearchAllAssets(true);
+
+	FARFilter Filter{};
+	Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	Filter.PackagePaths.Add(*SearchPath);
+	Filter.bRecursivePaths = true;
+
+	TArray<FAssetData> Assets{};
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	// Sorting keeps the generated file stable between runs, so it only changes when the layouts do
+	Assets.Sort([](const FAssetData& Lhs, const FAssetData& Rhs) { return Lhs.PackageName.LexicalLess(Rhs.PackageName); });
+
+	FString Body{};
+	TSet<FString> Includes{};
+	int32 AccessorCount{0};
+
+	for (const FAssetData& Asset : Assets)
+	{
+		const UBlueprint* Blueprint{Cast<UBlueprint>(Asset.GetAsset())};
+		if (Blueprint == nullptr || Blueprint->GeneratedClass == nullptr)
+		{
+			continue;
+		}
+
+		if (!Blueprint->GeneratedClass->IsChildOf(AActor::StaticClass()))
+		{
+			continue;
+		}
+
+		AccessorCount += GenerateClass(*Blueprint->GeneratedClass, Body, Includes);
+	}
+
+	TArray<FString> SortedIncludes{Includes.Array()};
+	SortedIncludes.Sort();
+
+	FString Output{};
+	Output += TEXT("// Generated by the EnhancedComponentCodegen commandlet from the Blueprint component layouts.\n");
+	Output += TEXT("// Do not edit by hand, run the commandlet again after changing the components of a Blueprint.\n\n");
+	Output += TEXT("#pragma once\n\n");
+	Output += TEXT("#include \"CoreMinimal.h\"\n");
+	Output += TEXT("#include \"GameFramework/Actor.h\"\n");
+	for (const FString& Include : SortedIncludes)
+	{
+		Output += FString::Printf(TEXT("#include \"%s\"\n"), *Include);
+	}
+	Output += TEXT("\nnamespace EnhancedComponentSlots\n{\n");
+	Output += Body;
+	Output += TEXT("}\n");
+
+	// Rewriting an identical file would trigger a rebuild of everything including it
+	FString Previous{};
+	if (FFileHelper::LoadFileToString(Previous, *OutputFile) && Previous == Output)
+	{
+		UE_LOG(LogEnhancedComponentReference, Display, TEXT("%s is up to date"), *OutputFile);
+		return 0;
+	}
+
+	if (!FFileHelper::SaveStringToFile(Output, *OutputFile))
+	{
+		UE_LOG(LogEnhancedComponentReference, Error, TEXT("Could not write %s"), *OutputFile);
+		return 1;
+	}
+
+	UE_LOG(LogEnhancedComponentReference, Display, TEXT("Wrote %d accessors to %s"), AccessorCount, *OutputFile);
+	return 0;
+#else
+	UE_LOG(LogEnhancedComponentReference, Error, TEXT("The slot generation needs the editor data of the Blueprints"));
+	return 1;
+#endif
+}
+
+int32 UEnhancedComponentCodegenCommandlet::GenerateClass(const UClass& ActorClass, FString& Output, TSet<FString>& Includes)
+{
+	FString Accessors{};
+	TSet<FString> UsedIdentifiers{};
+
+	UEnhancedComponentReference::ForEachDeclaredReference(ActorClass, [&](const UEnhancedComponentReference& Reference)
+	{
+		UClass* ReferenceType{Reference.LoadType()};
+		if (ReferenceType == nullptr || Reference.ComponentName.IsNone())
+		{
+			return;
+		}
+
+		// Only the Blueprint components have a fixed position, the C++ ones are already reachable from C++
+		const FEnhancedComponentResolutionPlan Plan{
+			FEnhancedComponentPlanCache::Compile(ActorClass, Reference.ComponentName, ReferenceType)
+		};
+		if (Plan.Step == EEnhancedComponentPlanStep::TypeMismatch
+			|| Plan.Slot.Kind != EEnhancedComponentSlotKind::Blueprint
+			|| Plan.Slot.BlueprintIndex == INDEX_NONE)
+		{
+			return;
+		}
+
+		// Blueprint component classes don't exist in C++, so the accessor returns their closest native class
+		const UClass* NativeType{ReferenceType};
+		while (NativeType != nullptr && !NativeType->HasAnyClassFlags(CLASS_Native))
+		{
+			NativeType = NativeType->GetSuperClass();
+		}
+		if (NativeType == nullptr)
+		{
+			return;
+		}
+
+#if WITH_EDITORONLY_DATA
+		if (const FString& IncludePath{NativeType->GetMetaData(TEXT("IncludePath"))}; !IncludePath.IsEmpty())
+		{
+			Includes.Add(IncludePath);
+		}
+#endif
+
+		FString Identifier{ToIdentifier(Reference.GetOuter()->GetName() + TEXT("_") + Reference.GetName())};
+		if (UsedIdentifiers.Contains(Identifier))
+		{
+			return;
+		}
+		UsedIdentifiers.Add(Identifier);
+
+		const FString TypeName{FString::Printf(TEXT("%s%s"), NativeType->GetPrefixCPP(), *NativeType->GetName())};
+		const FString ComponentName{Reference.ComponentName.ToString()};
+
+		Accessors += FString::Printf(
+			TEXT("\t\t/** %s on %s -> %s */\n"),
+			*Reference.GetName(),
+			*Reference.GetOuter()->GetName(),
+			*ComponentName);
+		Accessors += FString::Printf(TEXT("\t\tconstexpr int32 %s{%d};\n\n"), *Identifier, Plan.Slot.BlueprintIndex);
+		// The position only holds while the Blueprint matches the generated file, so everything gets checked in every
+		// configuration and a stale accessor gives null instead of a component of the wrong type
+		Accessors += FString::Printf(TEXT("\t\tinline %s* Get%s(const AActor& Actor)\n\t\t{\n"), *TypeName, *Identifier);
+		Accessors += FString::Printf(
+			TEXT("\t\t\tif (!Actor.BlueprintCreatedComponents.IsValidIndex(%s))\n\t\t\t{\n\t\t\t\treturn nullptr;\n\t\t\t}\n\n"),
+			*Identifier);
+		Accessors += FString::Printf(
+			TEXT("\t\t\tstatic const FName Name{TEXT(\"%s\")};\n"),
+			*ComponentName);
+		Accessors += FString::Printf(
+			TEXT("\t\t\tUActorComponent* Component{Actor.BlueprintCreatedComponents[%s]};\n"),
+			*Identifier);
+		Accessors += FString::Printf(
+			TEXT("\t\t\tif (Component == nullptr || Component->GetFName() != Name || !Component->IsA<%s>())\n\t\t\t{\n\t\t\t\treturn nullptr;\n\t\t\t}\n\n"),
+			*TypeName);
+		Accessors += FString::Printf(TEXT("\t\t\treturn static_cast<%s*>(Component);\n\t\t}\n\n"), *TypeName);
+	});
+
+	if (UsedIdentifiers.IsEmpty())
+	{
+		return 0;
+	}
+
+	Accessors.RemoveFromEnd(TEXT("\n"));
+	Output += FString::Printf(TEXT("\tnamespace %s\n\t{\n"), *ToIdentifier(ActorClass.GetName()));
+	Output += Accessors;
+	Output += TEXT("\t}\n\n");
+
+	return UsedIdentifiers.Num();
+}
+
+FString UEnhancedComponentCodegenCommandlet::ToIdentifier(const FString& Name)
+{
+	FString Output{Name};
+	for (TCHAR& Character : Output)
+	{
+		if (!FChar::IsAlnum(Character))
+		{
+			Character = TEXT('_');
+		}
+	}
+
+	if (Output.IsEmpty() || FChar::IsDigit(Output[0]))
+	{
+		Output.InsertAt(0, TEXT('_'));
+	}
+
+	return Output;
+}
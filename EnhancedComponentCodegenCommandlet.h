@@ -0,0 +1,48 @@
+﻿/**
+ * @file EnhancedComponentCodegenCommandlet.h
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Commandlet that writes a C++ header with constant slot indices and typed accessors for the references
+ * declared by the Blueprints. This is the opt-in ahead of time mode for the hottest references.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=EnhancedComponentCodegen [-Path=/Game/Characters] [-Output=<File>]
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "EnhancedComponentCodegenCommandlet.generated.h"
+
+class UEnhancedComponentReference;
+
+/**
+ * @brief Generates the header of constant slot indices from the Blueprint component layouts.
+ */
+UCLASS()
+class IDOLONDUTY_API UEnhancedComponentCodegenCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UEnhancedComponentCodegenCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/**
+	 * @brief Writes the namespace with the slots of the references declared by an actor class.
+	 * @param ActorClass The Blueprint generated class
+	 * @param Output The code being generated
+	 * @param Includes The headers needed for the component types used by the accessors
+	 * @return Amount of accessors written
+	 */
+	static int32 GenerateClass(const UClass& ActorClass, FString& Output, TSet<FString>& Includes);
+
+	/**
+	 * @brief Turns a name into a valid C++ identifier.
+	 */
+	[[nodiscard]] static FString ToIdentifier(const FString& Name);
+};
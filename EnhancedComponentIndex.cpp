@@ -0,0 +1,734 @@
+﻿/**
+ * @file EnhancedComponentIndex.cpp
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Implementation of the per-class component table used to resolve the enhanced component references.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#include "Utilities/Property/EnhancedComponentIndex.h"
+
+#include "Utilities/Property/EnhancedComponentReference.h"
+#include "Components/ActorComponent.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/SCS_Node.h"
+#include "Engine/SimpleConstructionScript.h"
+#include "GameFramework/Actor.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "UObject/UObjectGlobals.h"
+
+#if WITH_EDITOR
+#include "DerivedDataCacheInterface.h"
+#include "Engine/Blueprint.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#endif
+
+namespace
+{
+	/** Amount of seeds to try for a bucket before giving up on it (only possible if two names share a hash) */
+	constexpr uint32 MaxDisplacementSeed{1u << 16};
+
+	TMap<TObjectKey<UClass>, TSharedRef<const FEnhancedComponentIndex>> Indices{};
+
+	uint32 Generation{0};
+
+	/**
+	 * @brief Whether the index of the class can't be used anymore, because the class got unloaded or because it was
+	 * replaced by a recompiled one.
+	 */
+	bool IsStale(const UClass* IndexedClass)
+	{
+		return IndexedClass == nullptr || IndexedClass->HasAnyClassFlags(CLASS_NewerVersionExists);
+	}
+
+	// Cooked builds never invalidate anything, the indices of the classes unloaded with their levels go after the GC
+	FDelayedAutoRegisterHelper PruneIndices{
+		EDelayedRegisterRunPhase::ObjectSystemReady,
+		[]
+		{
+			FCoreUObjectDelegates::GetPostGarbageCollect().AddLambda([]
+			{
+				bool bPruned{false};
+				for (auto It{Indices.CreateIterator()}; It; ++It)
+				{
+					if (IsStale(It.Key().ResolveObjectPtr()))
+					{
+						It.RemoveCurrent();
+						bPruned = true;
+					}
+				}
+
+				// The plans hold slots of the indices, bumping the generation drops them as well
+				if (bPruned)
+				{
+					++Generation;
+				}
+			});
+		}
+	};
+
+#if WITH_EDITOR
+	TSet<TWeakObjectPtr<UBlueprint>> BoundBlueprints{};
+
+	/** Handles of the DDC requests issued when the Blueprints got loaded, by the key they ask for */
+	TMap<FString, uint32> PendingFetches{};
+
+	// The request goes out as soon as the Blueprint is loaded, so it is usually back by the time anything resolves
+	FDelayedAutoRegisterHelper PrefetchOnLoad{
+		EDelayedRegisterRunPhase::ObjectSystemReady,
+		[]
+		{
+			FCoreUObjectDelegates::OnAssetLoaded.AddLambda([](UObject* Asset)
+			{
+				const UBlueprint* Blueprint{Cast<UBlueprint>(Asset)};
+				const UClass* GeneratedClass{Blueprint != nullptr ? Blueprint->GeneratedClass.Get() : nullptr};
+				if (GeneratedClass != nullptr && GeneratedClass->IsChildOf(AActor::StaticClass()))
+				{
+					FEnhancedComponentIndex::Prefetch(*GeneratedClass);
+				}
+			});
+		}
+	};
+
+	/** Change this whenever the layout of the cached data or the way the slots get built changes */
+	const TCHAR* DerivedDataVersion{TEXT("5F0A9C3E71D24B86A2E84D19C6B07F53")};
+#endif
+
+	void CollectNodes(const USCS_Node* Node, TArray<const USCS_Node*>& Output)
+	{
+		if (Node == nullptr)
+		{
+			return;
+		}
+
+		// Nodes without a template don't create anything on the instances, and the editor-only templates are stripped
+		// when cooking, so counting them would shift the positions of every component after them in cooked builds
+		if (Node->ComponentTemplate != nullptr && !Node->ComponentTemplate->IsEditorOnly())
+		{
+			Output.Push(Node);
+		}
+
+		for (const USCS_Node* Child : Node->GetChildNodes())
+		{
+			CollectNodes(Child, Output);
+		}
+	}
+
+	/**
+	 * @brief Gets the nodes in the same order as the Simple Construction Script creates their components.
+	 */
+	TArray<const USCS_Node*> GetNodesInCreationOrder(const USimpleConstructionScript& Script)
+	{
+		TArray<const USCS_Node*> Output{};
+		for (const USCS_Node* Root : Script.GetRootNodes())
+		{
+			CollectNodes(Root, Output);
+		}
+		return Output;
+	}
+}
+
+TSharedRef<const FEnhancedComponentIndex> FEnhancedComponentIndex::Get(const UClass& ActorClass)
+{
+	check(IsInGameThread());
+
+	if (const TSharedRef<const FEnhancedComponentIndex>* Found{Indices.Find(&ActorClass)}; Found != nullptr)
+	{
+		return *Found;
+	}
+
+	const TSharedRef<FEnhancedComponentIndex> Index{MakeShared<FEnhancedComponentIndex>()};
+	Index->Build(ActorClass);
+	Indices.Add(&ActorClass, Index);
+
+#if WITH_EDITOR
+	// Editing or recompiling any Blueprint of the hierarchy changes the layout, so the table has to be built again
+	for (const UBlueprintGeneratedClass* BPClass : GetBlueprintHierarchy(ActorClass))
+	{
+		UBlueprint* Blueprint{Cast<UBlueprint>(BPClass->ClassGeneratedBy)};
+		if (Blueprint == nullptr || BoundBlueprints.Contains(Blueprint))
+		{
+			continue;
+		}
+
+		Blueprint->OnCompiled().AddStatic(&FEnhancedComponentIndex::HandleBlueprintChanged);
+		Blueprint->OnChanged().AddStatic(&FEnhancedComponentIndex::HandleBlueprintChanged);
+		BoundBlueprints.Add(Blueprint);
+	}
+#endif
+
+	return Index;
+}
+
+void FEnhancedComponentIndex::Invalidate(const UClass& ActorClass)
+{
+	check(IsInGameThread());
+
+	++Generation;
+
+	for (auto It{Indices.CreateIterator()}; It; ++It)
+	{
+		const UClass* IndexedClass{It.Key().ResolveObjectPtr()};
+		if (IsStale(IndexedClass) || IndexedClass->IsChildOf(&ActorClass))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+TArray<const UBlueprintGeneratedClass*> FEnhancedComponentIndex::GetBlueprintHierarchy(const UClass& ActorClass)
+{
+	TArray<const UBlueprintGeneratedClass*> Output{};
+	for (const UClass* Class{&ActorClass}; Class != nullptr; Class = Class->GetSuperClass())
+	{
+		if (const UBlueprintGeneratedClass* BPClass{Cast<UBlueprintGeneratedClass>(Class)}; BPClass != nullptr)
+		{
+			Output.Insert(BPClass, 0);
+		}
+	}
+	return Output;
+}
+
+uint32 FEnhancedComponentIndex::GetGeneration()
+{
+	return Generation;
+}
+
+const FEnhancedComponentSlot* FEnhancedComponentIndex::Find(const FName Name) const
+{
+	if (Table.IsEmpty() || Name.IsNone())
+	{
+		return nullptr;
+	}
+
+	const uint32 NameHash{HashName(Name)};
+	const uint32 Size{static_cast<uint32>(Table.Num())};
+
+	const int32 Displacement{Displacements[Displace(NameHash, 0) % Size]};
+	const int32 Position{
+		Displacement < 0
+			? -Displacement - 1
+			: static_cast<int32>(Displace(NameHash, static_cast<uint32>(Displacement)) % Size)
+	};
+
+	// Every name lands somewhere in a perfect hash, so the only check needed is whether it is the one stored there
+	const int32 SlotIndex{Table[Position]};
+	if (SlotIndex == INDEX_NONE || Slots[SlotIndex].Name != Name)
+	{
+		return nullptr;
+	}
+
+	return &Slots[SlotIndex];
+}
+
+const FEnhancedComponentSlot* FEnhancedComponentIndex::FindByGuid(const FGuid& Guid) const
+{
+	const int32* SlotIndex{SlotsByGuid.Find(Guid)};
+	return SlotIndex != nullptr ? &Slots[*SlotIndex] : nullptr;
+}
+
+UActorComponent* FEnhancedComponentIndex::Resolve(const FEnhancedComponentSlot& Slot, const AActor& Actor)
+{
+	UActorComponent* Component{nullptr};
+
+	if (Slot.Property != nullptr)
+	{
+		Component = Cast<UActorComponent>(Slot.Property->GetObjectPropertyValue_InContainer(&Actor));
+	}
+	else
+	{
+		switch (Slot.Kind)
+		{
+		case EEnhancedComponentSlotKind::Native:
+			Component = FindObjectFast<UActorComponent>(const_cast<AActor*>(&Actor), Slot.Name);
+			break;
+
+		case EEnhancedComponentSlotKind::Blueprint:
+			if (Actor.BlueprintCreatedComponents.IsValidIndex(Slot.BlueprintIndex))
+			{
+				Component = Actor.BlueprintCreatedComponents[Slot.BlueprintIndex];
+			}
+			break;
+
+		case EEnhancedComponentSlotKind::Instance:
+			if (const TArray<UActorComponent*>& InstanceComponents{Actor.GetInstanceComponents()};
+				InstanceComponents.IsValidIndex(Slot.InstanceIndex))
+			{
+				Component = InstanceComponents[Slot.InstanceIndex];
+			}
+			break;
+		}
+	}
+
+	// Instances can diverge from their class (components destroyed, reassigned or added by the construction script)
+	if (Component == nullptr || Component->GetFName() != Slot.Name)
+	{
+		return nullptr;
+	}
+
+	return Component;
+}
+
+TArray<FEnhancedComponentSlot> FEnhancedComponentIndex::GetInstanceSlots(const AActor& Actor)
+{
+	const TArray<UActorComponent*>& InstanceComponents{Actor.GetInstanceComponents()};
+
+	TArray<FEnhancedComponentSlot> Output{};
+	Output.Reserve(InstanceComponents.Num());
+
+	for (int32 Index{0}; Index < InstanceComponents.Num(); ++Index)
+	{
+		const UActorComponent* Component{InstanceComponents[Index]};
+		if (!IsValid(Component))
+		{
+			continue;
+		}
+
+		FEnhancedComponentSlot& Slot{Output.AddDefaulted_GetRef()};
+		Slot.Name = Component->GetFName();
+		Slot.ComponentClass = Component->GetClass();
+		Slot.Template = Component;
+		Slot.Kind = EEnhancedComponentSlotKind::Instance;
+		Slot.InstanceIndex = Index;
+	}
+
+	return Output;
+}
+
+uint32 FEnhancedComponentIndex::HashName(const FName Name)
+{
+	// FName comparisons are case-insensitive, so the hash has to be too
+	TCHAR Buffer[NAME_SIZE];
+	const uint32 Length{Name.GetPlainNameString(Buffer)};
+	for (uint32 Index{0}; Index < Length; ++Index)
+	{
+		Buffer[Index] = FChar::ToLower(Buffer[Index]);
+	}
+
+	return HashCombineFast(FCrc::MemCrc32(Buffer, Length * sizeof(TCHAR)), static_cast<uint32>(Name.GetNumber()));
+}
+
+uint32 FEnhancedComponentIndex::Displace(const uint32 NameHash, const uint32 Seed)
+{
+	return MurmurFinalize32(NameHash ^ (Seed * 0x9E3779B9u));
+}
+
+void FEnhancedComponentIndex::Build(const UClass& ActorClass)
+{
+	TSet<FName> SeenNames{};
+	BuildNativeSlots(ActorClass, SeenNames);
+
+#if WITH_EDITOR
+	// The slots are shared through the DDC between sessions, but only a request that already came back gets used.
+	// Waiting on the DDC would block the game thread for longer than walking the Blueprints does
+	const FString DerivedDataKey{GetDerivedDataKey(ActorClass)};
+	if (TArray<uint8> Data{}; !DerivedDataKey.IsEmpty() && TakePrefetched(DerivedDataKey, Data) &&
+		LoadFromDerivedData(ActorClass, Data))
+	{
+		BuildGuidTable();
+		return;
+	}
+#endif
+
+	BuildBlueprintSlots(ActorClass, SeenNames);
+
+	SlotHashes.Reserve(Slots.Num());
+	for (const FEnhancedComponentSlot& Slot : Slots)
+	{
+		SlotHashes.Push(HashName(Slot.Name));
+	}
+
+	BuildPerfectHash();
+	BuildGuidTable();
+
+#if WITH_EDITOR
+	if (!DerivedDataKey.IsEmpty())
+	{
+		SaveToDerivedData(DerivedDataKey);
+	}
+#endif
+}
+
+void FEnhancedComponentIndex::BuildNativeSlots(const UClass& ActorClass, TSet<FName>& SeenNames)
+{
+	// Native default subobjects are present on the CDO of every class, Blueprint generated ones included
+	if (const AActor* DefaultActor{Cast<AActor>(ActorClass.GetDefaultObject(false))}; DefaultActor != nullptr)
+	{
+		TArray<UActorComponent*> Components{};
+		DefaultActor->GetComponents(Components);
+
+		for (const UActorComponent* Component : Components)
+		{
+			if (Component == nullptr || SeenNames.Contains(Component->GetFName()))
+			{
+				continue;
+			}
+			SeenNames.Add(Component->GetFName());
+
+			FEnhancedComponentSlot& Slot{Slots.AddDefaulted_GetRef()};
+			Slot.Name = Component->GetFName();
+			Slot.ComponentClass = Component->GetClass();
+			Slot.Template = Component;
+			Slot.Kind = EEnhancedComponentSlotKind::Native;
+
+			for (TFieldIterator<FObjectPropertyBase> It{&ActorClass}; It; ++It)
+			{
+				if (It->GetObjectPropertyValue_InContainer(DefaultActor) == Component)
+				{
+					Slot.Property = *It;
+					break;
+				}
+			}
+		}
+	}
+}
+
+void FEnhancedComponentIndex::BuildBlueprintSlots(const UClass& ActorClass, TSet<FName>& SeenNames)
+{
+	// The construction goes from the top-most Blueprint down to this class, so the components of the parents get
+	// created first. Their templates can be overridden by the children through their inheritable component handler.
+	UBlueprintGeneratedClass* MostDerived{Cast<UBlueprintGeneratedClass>(const_cast<UClass*>(&ActorClass))};
+	int32 CreatedBefore{0};
+
+	for (const UBlueprintGeneratedClass* BPClass : GetBlueprintHierarchy(ActorClass))
+	{
+		if (BPClass->SimpleConstructionScript == nullptr)
+		{
+			continue;
+		}
+
+		const TArray<const USCS_Node*> Nodes{GetNodesInCreationOrder(*BPClass->SimpleConstructionScript)};
+		for (int32 NodeIndex{0}; NodeIndex < Nodes.Num(); ++NodeIndex)
+		{
+			const USCS_Node* Node{Nodes[NodeIndex]};
+			if (SeenNames.Contains(Node->GetVariableName()))
+			{
+				continue;
+			}
+			SeenNames.Add(Node->GetVariableName());
+
+			const UActorComponent* Template{Node->GetActualComponentTemplate(MostDerived)};
+			if (Template == nullptr)
+			{
+				Template = Node->ComponentTemplate;
+			}
+
+			FEnhancedComponentSlot& Slot{Slots.AddDefaulted_GetRef()};
+			Slot.Name = Node->GetVariableName();
+			Slot.ComponentClass = Template->GetClass();
+			Slot.Template = Template;
+			Slot.Kind = EEnhancedComponentSlotKind::Blueprint;
+			// The compiler generates a member variable for every node, which the construction assigns
+			Slot.Property = FindFProperty<FObjectPropertyBase>(&ActorClass, Slot.Name);
+			Slot.BlueprintIndex = CreatedBefore + NodeIndex;
+			Slot.Guid = Node->VariableGuid;
+		}
+
+		CreatedBefore += Nodes.Num();
+	}
+}
+
+#if WITH_EDITOR
+FString FEnhancedComponentIndex::GetDerivedDataKey(const UClass& ActorClass) const
+{
+	const TArray<const UBlueprintGeneratedClass*> Hierarchy{GetBlueprintHierarchy(ActorClass)};
+	if (Hierarchy.IsEmpty())
+	{
+		// C++ classes have nothing worth caching
+		return {};
+	}
+
+	// The Blueprint slots are placed after the C++ ones, so their names are part of the key
+	uint32 NativeHash{0};
+	for (const FEnhancedComponentSlot& Slot : Slots)
+	{
+		NativeHash = HashCombineFast(NativeHash, HashName(Slot.Name));
+	}
+
+	FString Suffix{FString::Printf(TEXT("%s_%08x"), *ActorClass.GetPathName(), NativeHash)};
+	for (const UBlueprintGeneratedClass* BPClass : Hierarchy)
+	{
+		// The saved hash doesn't know about the changes that haven't been saved yet
+		const UPackage* Package{BPClass->GetPackage()};
+		if (Package == nullptr || Package->IsDirty())
+		{
+			return {};
+		}
+
+		Suffix += TEXT("_") + LexToString(Package->GetSavedHash());
+	}
+
+	return FDerivedDataCacheInterface::BuildCacheKey(TEXT("ENHANCEDCOMPONENTINDEX"), DerivedDataVersion, *Suffix);
+}
+
+void FEnhancedComponentIndex::Prefetch(const UClass& ActorClass)
+{
+	if (Indices.Contains(&ActorClass) || ActorClass.HasAnyFlags(RF_NeedLoad | RF_NeedPostLoad))
+	{
+		return;
+	}
+
+	// The key depends on the C++ slots, which only need the CDO
+	FEnhancedComponentIndex Index{};
+	TSet<FName> SeenNames{};
+	Index.BuildNativeSlots(ActorClass, SeenNames);
+
+	const FString Key{Index.GetDerivedDataKey(ActorClass)};
+	if (Key.IsEmpty() || PendingFetches.Contains(Key))
+	{
+		return;
+	}
+
+	PendingFetches.Add(Key, GetDerivedDataCacheRef().GetAsynchronous(*Key, TEXTVIEW("EnhancedComponentIndex")));
+}
+
+bool FEnhancedComponentIndex::TakePrefetched(const FString& Key, TArray<uint8>& OutData)
+{
+	FDerivedDataCacheInterface& DerivedDataCache{GetDerivedDataCacheRef()};
+
+	bool bFound{false};
+	for (auto It{PendingFetches.CreateIterator()}; It; ++It)
+	{
+		// The requests that aren't back yet stay pending, their results still have to be collected once they are
+		if (!DerivedDataCache.PollAsynchronousCompletion(It.Value()))
+		{
+			continue;
+		}
+
+		TArray<uint8> Data{};
+		const bool bHit{DerivedDataCache.GetAsynchronousResults(It.Value(), Data)};
+		if (bHit && It.Key() == Key)
+		{
+			OutData = MoveTemp(Data);
+			bFound = true;
+		}
+
+		It.RemoveCurrent();
+	}
+
+	return bFound;
+}
+
+bool FEnhancedComponentIndex::LoadFromDerivedData(const UClass& ActorClass, const TArray<uint8>& Data)
+{
+	FMemoryReader Reader{Data, true};
+
+	int32 Count{0};
+	Reader << Count;
+
+	TArray<FEnhancedComponentSlot> Loaded{};
+	Loaded.Reserve(Count);
+	for (int32 Index{0}; Index < Count && !Reader.IsError(); ++Index)
+	{
+		FString ClassPath{};
+		FString TemplatePath{};
+		FName PropertyName{};
+
+		FEnhancedComponentSlot& Slot{Loaded.AddDefaulted_GetRef()};
+		Reader << Slot.Name;
+		Reader << ClassPath;
+		Reader << TemplatePath;
+		Reader << PropertyName;
+		Reader << Slot.BlueprintIndex;
+		Reader << Slot.Guid;
+
+		// The classes and templates are already loaded (they belong to the class being indexed), so this never loads
+		Slot.Kind = EEnhancedComponentSlotKind::Blueprint;
+		Slot.ComponentClass = FSoftClassPath{ClassPath}.ResolveClass();
+		Slot.Template = Cast<UActorComponent>(FSoftObjectPath{TemplatePath}.ResolveObject());
+		if (!PropertyName.IsNone())
+		{
+			Slot.Property = FindFProperty<FObjectPropertyBase>(&ActorClass, PropertyName);
+		}
+
+		if (!Slot.ComponentClass.IsValid() || !Slot.Template.IsValid())
+		{
+			return false;
+		}
+	}
+
+	TArray<uint32> LoadedHashes{};
+	TArray<int32> LoadedDisplacements{};
+	TArray<int32> LoadedTable{};
+	Reader << LoadedHashes;
+	Reader << LoadedDisplacements;
+	Reader << LoadedTable;
+
+	if (Reader.IsError() || LoadedHashes.Num() != Slots.Num() + Loaded.Num())
+	{
+		return false;
+	}
+
+	Slots.Append(MoveTemp(Loaded));
+	SlotHashes = MoveTemp(LoadedHashes);
+	Displacements = MoveTemp(LoadedDisplacements);
+	Table = MoveTemp(LoadedTable);
+
+	return true;
+}
+
+void FEnhancedComponentIndex::SaveToDerivedData(const FString& Key) const
+{
+	TArray<uint8> Data{};
+	FMemoryWriter Writer{Data, true};
+
+	TArray<const FEnhancedComponentSlot*> BlueprintSlots{};
+	for (const FEnhancedComponentSlot& Slot : Slots)
+	{
+		if (Slot.Kind == EEnhancedComponentSlotKind::Blueprint)
+		{
+			BlueprintSlots.Push(&Slot);
+		}
+	}
+
+	int32 Count{BlueprintSlots.Num()};
+	Writer << Count;
+
+	for (const FEnhancedComponentSlot* Slot : BlueprintSlots)
+	{
+		FName Name{Slot->Name};
+		FString ClassPath{FSoftClassPath{Slot->ComponentClass.Get()}.ToString()};
+		FString TemplatePath{FSoftObjectPath{Slot->Template.Get()}.ToString()};
+		FName PropertyName{Slot->Property != nullptr ? Slot->Property->GetFName() : NAME_None};
+		int32 BlueprintIndex{Slot->BlueprintIndex};
+		FGuid Guid{Slot->Guid};
+
+		Writer << Name;
+		Writer << ClassPath;
+		Writer << TemplatePath;
+		Writer << PropertyName;
+		Writer << BlueprintIndex;
+		Writer << Guid;
+	}
+
+	TArray<uint32> Hashes{SlotHashes};
+	TArray<int32> SavedDisplacements{Displacements};
+	TArray<int32> SavedTable{Table};
+	Writer << Hashes;
+	Writer << SavedDisplacements;
+	Writer << SavedTable;
+
+	GetDerivedDataCacheRef().Put(*Key, Data, TEXTVIEW("EnhancedComponentIndex"));
+}
+#endif
+
+void FEnhancedComponentIndex::BuildGuidTable()
+{
+	SlotsByGuid.Reserve(Slots.Num());
+	for (int32 Index{0}; Index < Slots.Num(); ++Index)
+	{
+		if (Slots[Index].Guid.IsValid())
+		{
+			SlotsByGuid.Add(Slots[Index].Guid, Index);
+		}
+	}
+}
+
+void FEnhancedComponentIndex::BuildPerfectHash()
+{
+	// This is the "hash, displace and compress" construction: the keys get split in buckets with the default seed,
+	// then the biggest buckets are placed first by searching a seed that sends all their keys to free positions.
+	const int32 Size{Slots.Num()};
+	Displacements.Init(0, Size);
+	Table.Init(INDEX_NONE, Size);
+
+	if (Size == 0)
+	{
+		return;
+	}
+
+	TArray<TArray<int32>> Buckets{};
+	Buckets.SetNum(Size);
+	for (int32 SlotIndex{0}; SlotIndex < Size; ++SlotIndex)
+	{
+		Buckets[Displace(SlotHashes[SlotIndex], 0) % Size].Push(SlotIndex);
+	}
+
+	TArray<int32> Order{};
+	Order.Reserve(Size);
+	for (int32 BucketIndex{0}; BucketIndex < Size; ++BucketIndex)
+	{
+		Order.Push(BucketIndex);
+	}
+	Order.Sort([&Buckets](const int32 Lhs, const int32 Rhs) { return Buckets[Lhs].Num() > Buckets[Rhs].Num(); });
+
+	TArray<int32> Positions{};
+	for (const int32 BucketIndex : Order)
+	{
+		const TArray<int32>& Bucket{Buckets[BucketIndex]};
+		if (Bucket.Num() <= 1)
+		{
+			break;
+		}
+
+		bool bPlaced{false};
+		for (uint32 Seed{1}; Seed < MaxDisplacementSeed && !bPlaced; ++Seed)
+		{
+			Positions.Reset();
+			bPlaced = true;
+
+			for (const int32 SlotIndex : Bucket)
+			{
+				const int32 Position{static_cast<int32>(Displace(SlotHashes[SlotIndex], Seed) % Size)};
+				if (Table[Position] != INDEX_NONE || Positions.Contains(Position))
+				{
+					bPlaced = false;
+					break;
+				}
+				Positions.Push(Position);
+			}
+
+			if (bPlaced)
+			{
+				for (int32 Index{0}; Index < Bucket.Num(); ++Index)
+				{
+					Table[Positions[Index]] = Bucket[Index];
+				}
+				Displacements[BucketIndex] = static_cast<int32>(Seed);
+			}
+		}
+
+		if (!bPlaced)
+		{
+			// The names of this bucket will just fall back to scanning the components
+			UE_LOG(
+				LogEnhancedComponentReference,
+				Warning,
+				TEXT("Could not place %d component names in the perfect hash (colliding name hashes)"),
+				Bucket.Num());
+		}
+	}
+
+	// The buckets with a single key point straight to one of the positions left
+	int32 FreePosition{0};
+	for (const int32 BucketIndex : Order)
+	{
+		const TArray<int32>& Bucket{Buckets[BucketIndex]};
+		if (Bucket.Num() != 1)
+		{
+			continue;
+		}
+
+		while (Table[FreePosition] != INDEX_NONE)
+		{
+			++FreePosition;
+		}
+
+		Table[FreePosition] = Bucket[0];
+		Displacements[BucketIndex] = -FreePosition - 1;
+	}
+}
+
+#if WITH_EDITOR
+void FEnhancedComponentIndex::HandleBlueprintChanged(UBlueprint* Blueprint)
+{
+	if (Blueprint == nullptr || Blueprint->GeneratedClass == nullptr)
+	{
+		return;
+	}
+
+	Invalidate(*Blueprint->GeneratedClass.Get());
+}
+#endif
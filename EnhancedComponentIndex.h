@@ -0,0 +1,198 @@
+﻿/**
+ * @file EnhancedComponentIndex.h
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Per-class table of the components that every instance of an actor class is guaranteed to have. The names
+ * are addressed through a minimal perfect hash so that references can be resolved without any collision probing.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class UActorComponent;
+class UBlueprint;
+class UBlueprintGeneratedClass;
+
+/**
+ * @brief Describes where a component from the index can be found on an instance of the class.
+ */
+enum class EEnhancedComponentSlotKind : uint8
+{
+	/** Default subobject created by the C++ constructor */
+	Native,
+
+	/** Component instanced from a node of the Simple Construction Script */
+	Blueprint,
+
+	/** Component added to a single actor placed in a level, these only come from GetInstanceSlots */
+	Instance,
+};
+
+/**
+ * @brief A component that is known to exist on every instance of the indexed class.
+ */
+struct FEnhancedComponentSlot
+{
+	/** Name that the component will have on the instances (no _GEN_VARIABLE suffix) */
+	FName Name;
+
+	/** Class of the component, this is the class of the template/default subobject */
+	TWeakObjectPtr<UClass> ComponentClass;
+
+	/**
+	 * The default subobject or node template the component gets created from. For inherited Blueprint components
+	 * this is the override of the indexed class when it has one.
+	 */
+	TWeakObjectPtr<const UActorComponent> Template;
+
+	EEnhancedComponentSlotKind Kind{EEnhancedComponentSlotKind::Native};
+
+	/** Property of the actor class holding the component, null if the component is not exposed through one */
+	const FObjectPropertyBase* Property{nullptr};
+
+	/** Where the component is expected to be in BlueprintCreatedComponents, this is a hint and must be verified */
+	int32 BlueprintIndex{INDEX_NONE};
+
+	/** Where the component is in the instance components of the actor, for the instance slots */
+	int32 InstanceIndex{INDEX_NONE};
+
+	/**
+	 * VariableGuid of the node for the Blueprint slots, this survives renaming the component. The C++ components
+	 * don't have one, their names are already fixed by the code.
+	 */
+	FGuid Guid;
+};
+
+/**
+ * @brief Table of the components of an actor class, merging the C++ components with the ones of every Blueprint in
+ * its hierarchy. The indices are built the first time a class is queried and they are rebuilt when any of the
+ * Blueprints changes or recompiles. The indices of unloaded or recompiled classes are dropped after the GC.
+ *
+ * The indices are shared without any locking, so they can only be used from the game thread.
+ */
+class IDOLONDUTY_API FEnhancedComponentIndex
+{
+public:
+	/**
+	 * @brief Gets the index for the class, building it if it wasn't built yet.
+	 * @param ActorClass The class of the actor (either C++ or Blueprint generated)
+	 * @return The index for the class
+	 */
+	[[nodiscard]] static TSharedRef<const FEnhancedComponentIndex> Get(const UClass& ActorClass);
+
+	/**
+	 * @brief Drops the index of the class and of all its children so that they get rebuilt the next time they are used.
+	 * @param ActorClass The class that changed
+	 */
+	static void Invalidate(const UClass& ActorClass);
+
+#if WITH_EDITOR
+	/**
+	 * @brief Requests the Blueprint slots of the class from the DDC without waiting for them, building the index
+	 * afterward uses them if they are back by then. This gets called when the Blueprints are loaded.
+	 */
+	static void Prefetch(const UClass& ActorClass);
+#endif
+
+	/**
+	 * @brief Counter that goes up every time an index gets invalidated, so anything derived from the indices knows
+	 * when it has to be rebuilt.
+	 */
+	[[nodiscard]] static uint32 GetGeneration();
+
+	/**
+	 * @brief Gets the Blueprint generated classes in the hierarchy of a class, starting from the top-most one.
+	 */
+	[[nodiscard]] static TArray<const UBlueprintGeneratedClass*> GetBlueprintHierarchy(const UClass& ActorClass);
+
+	/**
+	 * @brief Finds the slot for a name in constant time.
+	 * @param Name The name of the component in the instances
+	 * @return The slot or null if the class doesn't have a component with that name
+	 */
+	[[nodiscard]] const FEnhancedComponentSlot* Find(const FName Name) const;
+
+	/**
+	 * @brief Finds the slot of a Blueprint component from the VariableGuid of its node.
+	 * @param Guid The guid of the node
+	 * @return The slot or null if no node of the hierarchy has that guid
+	 */
+	[[nodiscard]] const FEnhancedComponentSlot* FindByGuid(const FGuid& Guid) const;
+
+	/**
+	 * @brief Fetches the component of the slot from an instance of the indexed class.
+	 * @param Slot Slot obtained from this index
+	 * @param Actor Instance of the indexed class
+	 * @return The component or null if the instance doesn't match the layout of the class anymore
+	 */
+	[[nodiscard]] static UActorComponent* Resolve(const FEnhancedComponentSlot& Slot, const AActor& Actor);
+
+	[[nodiscard]] const TArray<FEnhancedComponentSlot>& GetSlots() const { return Slots; }
+
+	/**
+	 * @brief Gets the slots of the components added to a placed actor, on top of the ones of its class (this includes
+	 * the actors placed inside Level Instances). These aren't part of any class, so they don't get indexed.
+	 * @param Actor The placed actor
+	 * @return The slots, in the order of the instance components of the actor
+	 */
+	[[nodiscard]] static TArray<FEnhancedComponentSlot> GetInstanceSlots(const AActor& Actor);
+
+	/**
+	 * @brief Hash of the name that doesn't depend on the session (FName indices change between runs).
+	 */
+	[[nodiscard]] static uint32 HashName(const FName Name);
+
+private:
+	void Build(const UClass& ActorClass);
+	void BuildNativeSlots(const UClass& ActorClass, TSet<FName>& SeenNames);
+	void BuildBlueprintSlots(const UClass& ActorClass, TSet<FName>& SeenNames);
+	void BuildPerfectHash();
+	void BuildGuidTable();
+
+#if WITH_EDITOR
+	/**
+	 * @brief Key of the Blueprint slots in the DDC, built from the saved hash of every package in the hierarchy.
+	 * This has to be called after the native slots are built.
+	 * @return The key or an empty string if the index can't be cached (C++ class or unsaved changes)
+	 */
+	[[nodiscard]] FString GetDerivedDataKey(const UClass& ActorClass) const;
+
+	/**
+	 * @brief Gets the data of a prefetched request if it already came back, this never waits on the DDC.
+	 * @return Whether the request was back and found the data
+	 */
+	static bool TakePrefetched(const FString& Key, TArray<uint8>& OutData);
+
+	/**
+	 * @brief Appends the Blueprint slots and the perfect hash stored in the DDC to the native slots.
+	 * @return Whether the data is still valid for the loaded classes
+	 */
+	bool LoadFromDerivedData(const UClass& ActorClass, const TArray<uint8>& Data);
+
+	void SaveToDerivedData(const FString& Key) const;
+#endif
+
+	[[nodiscard]] static uint32 Displace(const uint32 NameHash, const uint32 Seed);
+
+#if WITH_EDITOR
+	static void HandleBlueprintChanged(UBlueprint* Blueprint);
+#endif
+
+	TArray<FEnhancedComponentSlot> Slots;
+
+	/** Hash of the name of each slot, kept to avoid rehashing the strings when the table gets built */
+	TArray<uint32> SlotHashes;
+
+	/** Per bucket, either the seed used to displace its keys or the slot it points to directly (stored as -Slot - 1) */
+	TArray<int32> Displacements;
+
+	/** Slot stored at each position of the table */
+	TArray<int32> Table;
+
+	/** Slot of each Blueprint component by the VariableGuid of its node */
+	TMap<FGuid, int32> SlotsByGuid;
+};
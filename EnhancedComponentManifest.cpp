@@ -0,0 +1,216 @@
+﻿/**
+ * @file EnhancedComponentManifest.cpp
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Implementation of the cooked manifest of the enhanced component references.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#include "Utilities/Property/EnhancedComponentManifest.h"
+
+#include "Utilities/Property/EnhancedComponentReference.h"
+#include "Algo/BinarySearch.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Hash/CityHash.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	/**
+	 * @brief Layout of the start of the file, the entries come right after it.
+	 */
+	struct FManifestHeader
+	{
+		uint32 Magic{0};
+		uint32 Version{0};
+		uint32 EntryCount{0};
+		uint32 Padding{0};
+	};
+
+	constexpr uint32 ManifestMagic{0x4D524345}; // "ECRM"
+	constexpr uint32 ManifestVersion{2};
+
+	// Mapping it at startup keeps the first resolutions of the match from paying for it
+	FDelayedAutoRegisterHelper MapManifest{
+		EDelayedRegisterRunPhase::EndOfEngineInit,
+		[] { (void)FEnhancedComponentManifest::Get(); }
+	};
+}
+
+FEnhancedComponentManifest::~FEnhancedComponentManifest() = default;
+
+const FEnhancedComponentManifest& FEnhancedComponentManifest::Get()
+{
+	static const TUniquePtr<FEnhancedComponentManifest> Manifest{
+		[]
+		{
+			TUniquePtr<FEnhancedComponentManifest> Output{MakeUnique<FEnhancedComponentManifest>()};
+
+			// The layouts can change at any moment in the editor, so the manifest only makes sense for cooked data
+			if (FPlatformProperties::RequiresCookedData())
+			{
+				Output->Map(GetDefaultPath());
+			}
+
+			return Output;
+		}()
+	};
+
+	return *Manifest;
+}
+
+bool FEnhancedComponentManifest::FindPlan(
+	const UClass& ActorClass,
+	const FName ComponentName,
+	const UClass* Type,
+	FEnhancedComponentResolutionPlan& OutPlan) const
+{
+	if (Entries.IsEmpty())
+	{
+		return false;
+	}
+
+	const int32 Found{
+		static_cast<int32>(Algo::BinarySearchBy(Entries, MakeKey(ActorClass, ComponentName, Type),
+		                                        &FEnhancedComponentManifestEntry::Key))
+	};
+	if (Found == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const FEnhancedComponentManifestEntry& Entry{Entries[Found]};
+	OutPlan.Step = Entry.Step;
+	OutPlan.Slot.Name = ComponentName;
+	OutPlan.Slot.Kind = Entry.Kind;
+	OutPlan.Slot.BlueprintIndex = Entry.BlueprintIndex;
+
+	return true;
+}
+
+uint64 FEnhancedComponentManifest::MakeKey(const UClass& ActorClass, const FName ComponentName, const UClass* Type)
+{
+	// FNames compare without case, so the key can't depend on it either
+	const FString Source{
+		FString::Printf(
+			TEXT("%s|%s|%s"),
+			*ActorClass.GetPathName(),
+			*ComponentName.ToString(),
+			Type != nullptr ? *Type->GetPathName() : TEXT("None")).ToLower()
+	};
+
+	return CityHash64(reinterpret_cast<const char*>(*Source), Source.Len() * sizeof(TCHAR));
+}
+
+FEnhancedComponentManifestEntry FEnhancedComponentManifest::MakeEntry(
+	const UClass& ActorClass,
+	const FName ComponentName,
+	const UClass* Type,
+	const FEnhancedComponentResolutionPlan& Plan)
+{
+	FEnhancedComponentManifestEntry Output{};
+	Output.Key = MakeKey(ActorClass, ComponentName, Type);
+	Output.Step = Plan.Step;
+	Output.Kind = Plan.Slot.Kind;
+	Output.BlueprintIndex = Plan.Slot.BlueprintIndex;
+
+	// Properties can't be stored, the slot is read through its position or its name instead
+	if (Output.Step == EEnhancedComponentPlanStep::ReadProperty)
+	{
+		const bool bHasIndex{Output.Kind == EEnhancedComponentSlotKind::Blueprint && Output.BlueprintIndex != INDEX_NONE};
+		Output.Step = bHasIndex ? EEnhancedComponentPlanStep::BlueprintIndex : EEnhancedComponentPlanStep::FindSubobject;
+	}
+
+	return Output;
+}
+
+bool FEnhancedComponentManifest::Write(const FString& Path, TArray<FEnhancedComponentManifestEntry> Entries)
+{
+	Entries.Sort([](const FEnhancedComponentManifestEntry& Lhs, const FEnhancedComponentManifestEntry& Rhs)
+	{
+		return Lhs.Key < Rhs.Key;
+	});
+
+	// The same pair shows up once per Blueprint inheriting the reference
+	for (int32 Index{Entries.Num() - 1}; Index > 0; --Index)
+	{
+		if (Entries[Index].Key == Entries[Index - 1].Key)
+		{
+			Entries.RemoveAt(Index, EAllowShrinking::No);
+		}
+	}
+
+	const TUniquePtr<FArchive> Writer{IFileManager::Get().CreateFileWriter(*Path)};
+	if (Writer == nullptr)
+	{
+		return false;
+	}
+
+	FManifestHeader Header{};
+	Header.Magic = ManifestMagic;
+	Header.Version = ManifestVersion;
+	Header.EntryCount = static_cast<uint32>(Entries.Num());
+
+	Writer->Serialize(&Header, sizeof(Header));
+	Writer->Serialize(Entries.GetData(), Entries.Num() * sizeof(FEnhancedComponentManifestEntry));
+
+	return Writer->Close();
+}
+
+FString FEnhancedComponentManifest::GetDefaultPath()
+{
+	return FPaths::Combine(FPaths::ProjectContentDir(), TEXT("EnhancedComponentReference"), TEXT("ReferenceManifest.bin"));
+}
+
+void FEnhancedComponentManifest::Map(const FString& Path)
+{
+	Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path));
+	if (Handle == nullptr)
+	{
+		UE_LOG(
+			LogEnhancedComponentReference,
+			Log,
+			TEXT("No reference manifest at %s, the plans will be compiled at runtime"),
+			*Path);
+		return;
+	}
+
+	const int64 Size{Handle->GetFileSize()};
+	if (Size < static_cast<int64>(sizeof(FManifestHeader)))
+	{
+		UE_LOG(LogEnhancedComponentReference, Warning, TEXT("The reference manifest %s is truncated"), *Path);
+		return;
+	}
+
+	Region.Reset(Handle->MapRegion(0, Size));
+	if (Region == nullptr)
+	{
+		UE_LOG(LogEnhancedComponentReference, Warning, TEXT("Could not map the reference manifest %s"), *Path);
+		return;
+	}
+
+	const uint8* Data{Region->GetMappedPtr()};
+	const FManifestHeader& Header{*reinterpret_cast<const FManifestHeader*>(Data)};
+
+	const int64 ExpectedSize{
+		static_cast<int64>(sizeof(FManifestHeader) + Header.EntryCount * sizeof(FEnhancedComponentManifestEntry))
+	};
+	if (Header.Magic != ManifestMagic || Header.Version != ManifestVersion || ExpectedSize != Size)
+	{
+		UE_LOG(
+			LogEnhancedComponentReference,
+			Warning,
+			TEXT("The reference manifest %s is outdated, cook the project again"),
+			*Path);
+		Region.Reset();
+		return;
+	}
+
+	Entries = MakeArrayView(
+		reinterpret_cast<const FEnhancedComponentManifestEntry*>(Data + sizeof(FManifestHeader)),
+		static_cast<int32>(Header.EntryCount));
+}
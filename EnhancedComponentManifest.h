@@ -0,0 +1,106 @@
+﻿/**
+ * @file EnhancedComponentManifest.h
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Binary manifest with the plans of every (class, reference) pair of the project, written when cooking and
+ * memory mapped by cooked builds so that the plans don't need the class indices to be built at runtime.
+ *
+ * The file has to be staged as a loose file (add EnhancedComponentReference to "Additional Non-Asset Directories to
+ * Copy" in the packaging settings), files inside the pak can't be memory mapped.
+ *
+ * The cook doesn't write the manifest by itself. It has to be regenerated by running the audit commandlet with
+ * -Manifest before every cook that changes the Blueprints. The entries are only hints: the slots they point to get
+ * verified on every resolution, the scans verify themselves, and the mismatches get compiled again at runtime.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utilities/Property/EnhancedComponentResolutionPlan.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * @brief Entry of the manifest, this is the layout used in the file so it can be read in place.
+ */
+struct FEnhancedComponentManifestEntry
+{
+	/** Hash of the class, the component name and the type (see FEnhancedComponentManifest::MakeKey) */
+	uint64 Key{0};
+
+	/** Position in BlueprintCreatedComponents for the Blueprint slots */
+	int32 BlueprintIndex{INDEX_NONE};
+
+	EEnhancedComponentPlanStep Step{EEnhancedComponentPlanStep::Scan};
+
+	EEnhancedComponentSlotKind Kind{EEnhancedComponentSlotKind::Native};
+
+	uint16 Padding{0};
+};
+
+static_assert(sizeof(FEnhancedComponentManifestEntry) == 16, "The manifest entries are read in place from the file");
+
+/**
+ * @brief Read-only view over the memory mapped manifest.
+ */
+class IDOLONDUTY_API FEnhancedComponentManifest
+{
+public:
+	~FEnhancedComponentManifest();
+
+	/**
+	 * @brief Gets the manifest, this is empty outside of cooked builds or if the file wasn't staged.
+	 */
+	[[nodiscard]] static const FEnhancedComponentManifest& Get();
+
+	/**
+	 * @brief Gets the plan that was compiled when cooking for the pair.
+	 * @param ActorClass The class of the actor being resolved
+	 * @param ComponentName The name of the component
+	 * @param Type The type of the reference
+	 * @param OutPlan The plan, only written when found
+	 * @return Whether the pair is in the manifest
+	 */
+	[[nodiscard]] bool FindPlan(
+		const UClass& ActorClass,
+		const FName ComponentName,
+		const UClass* Type,
+		FEnhancedComponentResolutionPlan& OutPlan) const;
+
+	/**
+	 * @brief Makes the key of a pair, this only depends on the paths so the editor and the cooked builds agree on it.
+	 */
+	[[nodiscard]] static uint64 MakeKey(const UClass& ActorClass, const FName ComponentName, const UClass* Type);
+
+	/**
+	 * @brief Makes the entry for a plan compiled in the editor.
+	 */
+	[[nodiscard]] static FEnhancedComponentManifestEntry MakeEntry(
+		const UClass& ActorClass,
+		const FName ComponentName,
+		const UClass* Type,
+		const FEnhancedComponentResolutionPlan& Plan);
+
+	/**
+	 * @brief Writes the entries to a manifest file (sorting and removing the duplicated keys).
+	 * @return Whether the file could be written
+	 */
+	static bool Write(const FString& Path, TArray<FEnhancedComponentManifestEntry> Entries);
+
+	/**
+	 * @brief Where the manifest gets written to and mapped from by default.
+	 */
+	[[nodiscard]] static FString GetDefaultPath();
+
+private:
+	void Map(const FString& Path);
+
+	TUniquePtr<IMappedFileHandle> Handle;
+	TUniquePtr<IMappedFileRegion> Region;
+
+	/** Entries sorted by key, pointing into the mapped region */
+	TConstArrayView<FEnhancedComponentManifestEntry> Entries;
+};
@@ -10,11 +10,46 @@
 
 #include "Utilities/Property/EnhancedComponentReference.h"
 
+#include "Utilities/Property/EnhancedComponentIndex.h"
+#include "Utilities/Property/EnhancedComponentResolutionPlan.h"
+#include "Engine/AssetManager.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/StreamableManager.h"
+#include "Components/ChildActorComponent.h"
+#include "Serialization/CustomVersion.h"
+#include "UObject/UObjectHash.h"
+
 #if WITH_EDITOR
-#include "Engine/SCS_Node.h"
-#include "Engine/SimpleConstructionScript.h"
+#include "Engine/Blueprint.h"
+#include "UObject/ObjectSaveContext.h"
 #endif
 
+const FGuid FEnhancedComponentReferenceVersion::GUID{0x6C3B2A51, 0x8E4F4D07, 0x9A1C5E22, 0x47D90B3F};
+
+namespace
+{
+	FCustomVersionRegistration RegisterReferenceVersion{
+		FEnhancedComponentReferenceVersion::GUID,
+		FEnhancedComponentReferenceVersion::LatestVersion,
+		TEXT("EnhancedComponentReference")
+	};
+
+	/** Bits of the flags byte at the start of the packed record */
+	enum class EPackedRecordFlags : uint8
+	{
+		None = 0,
+		UseOtherAsset = 1 << 0,
+		SoftType = 1 << 1,
+		BakedInstanceComponent = 1 << 2,
+		Interface = 1 << 3,
+
+		/** Nothing else follows, the instance has the same record as its archetype */
+		MatchesArchetype = 1 << 4,
+	};
+
+	ENUM_CLASS_FLAGS(EPackedRecordFlags)
+}
+
 UEnhancedComponentReference* UEnhancedComponentReference::Create(
 	const TSubclassOf<UActorComponent> Type,
 	UObject* Owner,
@@ -50,13 +85,149 @@ UEnhancedComponentReference* UEnhancedComponentReference::Create(
 	return Output;
 }
 
-// This function could be optimized, but I think that there really isn't much need for this
+UEnhancedComponentReference* UEnhancedComponentReference::CreateSoft(
+	const TSoftClassPtr<UActorComponent>& Type,
+	UObject* Owner,
+	const FName Name)
+{
+	if (Type.IsNull())
+	{
+		UE_LOG(
+			LogEnhancedComponentReference,
+			Warning,
+			TEXT("The type provided is invalid, check the class path being provided."));
+		return nullptr;
+	}
+
+	if (Owner == nullptr)
+	{
+		UE_LOG(
+			LogEnhancedComponentReference,
+			Warning,
+			TEXT("The owner being provided is null"));
+		return nullptr;
+	}
+
+	FName ToAssign{Type.GetAssetName() + TEXT("_Ref")};
+	if (not Name.IsNone())
+	{
+		ToAssign = Name;
+	}
+
+	UEnhancedComponentReference* Output{Owner->CreateDefaultSubobject<UEnhancedComponentReference>(ToAssign)};
+	Output->SoftType = Type;
+
+	return Output;
+}
+
+UEnhancedComponentReference* UEnhancedComponentReference::CreateInterface(
+	const TSubclassOf<UInterface> Interface,
+	UObject* Owner,
+	const FName Name)
+{
+	if (Interface == nullptr || !Interface->HasAnyClassFlags(CLASS_Interface))
+	{
+		UE_LOG(
+			LogEnhancedComponentReference,
+			Warning,
+			TEXT("The interface provided is invalid, check the UClass being provided."));
+		return nullptr;
+	}
+
+	FName ToAssign{Interface->GetName() + TEXT("_Ref")};
+	if (not Name.IsNone())
+	{
+		ToAssign = Name;
+	}
+
+	UEnhancedComponentReference* Output{Create(UActorComponent::StaticClass(), Owner, ToAssign)};
+	if (Output != nullptr)
+	{
+		Output->InterfaceType = Interface;
+	}
+
+	return Output;
+}
+
+UClass* UEnhancedComponentReference::GetType() const
+{
+	return SoftType.IsNull() ? Type.Get() : SoftType.Get();
+}
+
+UClass* UEnhancedComponentReference::LoadType() const
+{
+	return SoftType.IsNull() ? Type.Get() : SoftType.LoadSynchronous();
+}
+
 #if WITH_EDITOR
+namespace
+{
+	/**
+	 * @brief Options of the dropdown for the object holding the components and the type being filtered by.
+	 */
+	struct FDropdownKey
+	{
+		TObjectKey<UObject> Source;
+		TObjectKey<UClass> Type;
+		TObjectKey<UClass> Interface;
+
+		bool operator==(const FDropdownKey& Other) const
+		{
+			return Source == Other.Source && Type == Other.Type && Interface == Other.Interface;
+		}
+
+		friend uint32 GetTypeHash(const FDropdownKey& Key)
+		{
+			return HashCombineFast(
+				HashCombineFast(GetTypeHash(Key.Source), GetTypeHash(Key.Type)),
+				GetTypeHash(Key.Interface));
+		}
+	};
+
+	/**
+	 * @brief Options of a dropdown, with the classes of the child actors they were taken from.
+	 */
+	struct FDropdownEntry
+	{
+		TArray<FString> Names;
+		TArray<TWeakObjectPtr<const UClass>> ChildActorClasses;
+	};
+
+	TMap<FDropdownKey, FDropdownEntry> DropdownCache{};
+
+	TSet<TWeakObjectPtr<UBlueprint>> DropdownBoundBlueprints{};
+
+	void InvalidateDropdowns(UBlueprint* Blueprint)
+	{
+		const UClass* Changed{Blueprint != nullptr ? Blueprint->GeneratedClass.Get() : nullptr};
+
+		for (auto It{DropdownCache.CreateIterator()}; It; ++It)
+		{
+			const UClass* Source{Cast<UClass>(It.Key().Source.ResolveObjectPtr())};
+			if (Source == nullptr || Changed == nullptr || Source->IsChildOf(Changed))
+			{
+				It.RemoveCurrent();
+				continue;
+			}
+
+			// The paths into the child actors depend on their classes as well
+			for (const TWeakObjectPtr<const UClass>& ChildActorClass : It.Value().ChildActorClasses)
+			{
+				if (!ChildActorClass.IsValid() || ChildActorClass->IsChildOf(Changed))
+				{
+					It.RemoveCurrent();
+					break;
+				}
+			}
+		}
+	}
+}
+
 TArray<FString> UEnhancedComponentReference::GetAvailableComponentNames() const
 {
 	if (bUseOtherAsset)
 	{
-		if (ProvidedArchetype == nullptr)
+		if (ProvidedArchetype.IsNull())
 		{
 			UE_LOG(
 				LogEnhancedComponentReference,
@@ -66,7 +237,7 @@ TArray<FString> UEnhancedComponentReference::GetAvailableComponentNames() const
 		}
 	}
 
-	if (!Type->IsValidLowLevel())
+	if (!LoadType()->IsValidLowLevel())
 	{
 		UE_LOG(
 			LogEnhancedComponentReference,
@@ -75,24 +246,123 @@ TArray<FString> UEnhancedComponentReference::GetAvailableComponentNames() const
 		return {};
 	}
 
-	const UObject* Outer{not bUseOtherAsset ? GetOutermostObject() : ProvidedArchetype->GetOutermostObject(),};
+	// The dropdown is the only place where the archetype has to be loaded. Without one the class comes from the
+	// outers, which works the same for references declared on actors and on their components
+	const UObject* Outer{not bUseOtherAsset ? FindOwnerClass() : ProvidedArchetype.LoadSynchronous()};
 	if (Outer == nullptr)
 	{
 		UE_LOG(
 			LogEnhancedComponentReference,
 			Warning,
-			TEXT(""));
+			TEXT("%s is not declared on an actor or on one of its components"),
+			*GetPathName());
 		return {};
 	}
 
-	// Handle the cases where the Outer has the class of the blueprint, and we need to manage from there
-	if (Cast<AActor>(Outer) != nullptr)
+	const FDropdownKey Key{Outer, GetType(), InterfaceType.Get()};
+	if (const FDropdownEntry* Cached{DropdownCache.Find(Key)}; Cached != nullptr)
 	{
-		Outer = Outer->GetClass();
+		return AppendInstanceComponentNames(Cached->Names);
 	}
 
-	const AActor* Actor{ObjToActor(Outer)};
-	if (Actor == nullptr)
+	TArray<const UClass*> Sources{};
+	FDropdownEntry& Entry{DropdownCache.Add(Key)};
+	Entry.Names = CollectAvailableComponentNames(*Outer, Sources);
+	Entry.ChildActorClasses.Append(Sources);
+	Sources.Push(Cast<UClass>(Outer));
+
+	// The list only changes when one of the Blueprints in the hierarchies gets edited or recompiled
+	for (const UClass* Source : Sources)
+	{
+		for (const UClass* Class{Source}; Class != nullptr; Class = Class->GetSuperClass())
+		{
+			UBlueprint* Blueprint{Cast<UBlueprint>(Class->ClassGeneratedBy)};
+			if (Blueprint == nullptr || DropdownBoundBlueprints.Contains(Blueprint))
+			{
+				continue;
+			}
+
+			Blueprint->OnCompiled().AddStatic(&InvalidateDropdowns);
+			Blueprint->OnChanged().AddStatic(&InvalidateDropdowns);
+			DropdownBoundBlueprints.Add(Blueprint);
+		}
+	}
+
+	return AppendInstanceComponentNames(Entry.Names);
+}
+
+void UEnhancedComponentReference::PreSave(FObjectPreSaveContext SaveContext)
+{
+	Super::PreSave(SaveContext);
+
+	// This also runs before cooking, so the cooked name is always the current one
+	SyncComponentGuid();
+}
+
+void UEnhancedComponentReference::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Any of the properties can change what the reference resolves to
+	ResetCaches();
+
+	// A name picked from the dropdown is the one to follow, so the guid gets taken from it
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(UEnhancedComponentReference, ComponentName))
+	{
+		ComponentGuid.Invalidate();
+		SyncComponentGuid();
+	}
+}
+
+void UEnhancedComponentReference::SyncComponentGuid()
+{
+	const UClass* OwnerClass{FindOwnerClass()};
+	if (OwnerClass == nullptr)
+	{
+		return;
+	}
+
+	const TSharedRef<const FEnhancedComponentIndex> Index{FEnhancedComponentIndex::Get(*OwnerClass)};
+	if (const FEnhancedComponentSlot* Slot{ComponentGuid.IsValid() ? Index->FindByGuid(ComponentGuid) : nullptr};
+		Slot != nullptr)
+	{
+		ComponentName = Slot->Name;
+		return;
+	}
+
+	// Paths into child actors, C++ components and instance components don't have a guid
+	const FEnhancedComponentSlot* Slot{Index->Find(ComponentName)};
+	ComponentGuid = Slot != nullptr ? Slot->Guid : FGuid{};
+}
+
+TArray<FString> UEnhancedComponentReference::AppendInstanceComponentNames(TArray<FString> Names) const
+{
+	// The components added to a placed actor change without any event, so these don't go through the cache
+	const AActor* Instance{not bUseOtherAsset ? FindOwnerInstance() : nullptr};
+	if (Instance == nullptr)
+	{
+		return Names;
+	}
+
+	const UClass* FilterType{GetType()};
+	for (const FEnhancedComponentSlot& Slot : FEnhancedComponentIndex::GetInstanceSlots(*Instance))
+	{
+		if (const UClass* ComponentClass{Slot.ComponentClass.Get()};
+			ComponentClass != nullptr && AcceptsClass(*ComponentClass, FilterType))
+		{
+			Names.AddUnique(Slot.Name.ToString());
+		}
+	}
+
+	return Names;
+}
+
+TArray<FString> UEnhancedComponentReference::CollectAvailableComponentNames(
+	const UObject& Outer,
+	TArray<const UClass*>& OutChildActorClasses) const
+{
+	const UClass* ActorClass{Cast<UClass>(&Outer)};
+	if (ActorClass == nullptr || !ActorClass->IsChildOf(AActor::StaticClass()))
 	{
 		UE_LOG(
 			LogEnhancedComponentReference,
@@ -101,57 +371,61 @@ TArray<FString> UEnhancedComponentReference::GetAvailableComponentNames() const
 		return {};
 	}
 
+	const UClass* FilterType{GetType()};
 	TArray<FString> Output;
 
-	// Checking the BP side of things
-
-	if (const UBlueprintGeneratedClass* BPClass{Cast<UBlueprintGeneratedClass>(Outer)}; BPClass != nullptr)
+	// The index has both the C++ components and the ones of every Blueprint in the hierarchy (with their overrides)
+	for (const FEnhancedComponentSlot& Slot : FEnhancedComponentIndex::Get(*ActorClass)->GetSlots())
 	{
-		const UBlueprint* Blueprint{Cast<UBlueprint>(BPClass->ClassGeneratedBy)};
-		if (Blueprint != nullptr)
+		const UClass* ComponentClass{Slot.ComponentClass.Get()};
+		if (ComponentClass == nullptr)
 		{
-			const TArray Nodes{Blueprint->SimpleConstructionScript->GetAllNodes()};
-			for (const USCS_Node* Node : Nodes)
-			{
-				const UActorComponent* BPComponent = Cast<UActorComponent>(Node->ComponentTemplate);
-				if (BPComponent == nullptr)
-				{
-					continue;
-				}
+			continue;
+		}
 
-				if (!BPComponent->GetClass()->IsChildOf(Type))
-				{
-					continue;
-				}
+		if (AcceptsClass(*ComponentClass, FilterType))
+		{
+			Output.Push(Slot.Name.ToString());
+		}
 
-				// We are removing the part that is appended for the serialization by the engine
-				const FString Ending{"_GEN_VARIABLE"};
-				FString ReadableName{BPComponent->GetName()};
-				ReadableName.RemoveFromEnd(Ending);
+		// The child actor only exists on the instances, but its class is known from the template
+		const UChildActorComponent* ChildActorTemplate{Cast<UChildActorComponent>(Slot.Template.Get())};
+		const UClass* ChildActorClass{
+			ChildActorTemplate != nullptr ? ChildActorTemplate->GetChildActorClass().Get() : nullptr
+		};
+		if (ChildActorClass == nullptr)
+		{
+			continue;
+		}
 
-				Output.Push(ReadableName);
+		OutChildActorClasses.Push(ChildActorClass);
+		for (const FEnhancedComponentSlot& ChildSlot : FEnhancedComponentIndex::Get(*ChildActorClass)->GetSlots())
+		{
+			if (const UClass* ChildComponentClass{ChildSlot.ComponentClass.Get()};
+				ChildComponentClass != nullptr && AcceptsClass(*ChildComponentClass, FilterType))
+			{
+				Output.Push(Slot.Name.ToString() + TEXT(".") + ChildSlot.Name.ToString());
 			}
 		}
 	}
 
-	// Checking the C++ side of things
-
-	TArray<UActorComponent*> Components{};
-	Actor->GetComponents(Type, Components);
-
-	for (const UActorComponent* CurrentComponent : Components)
-	{
-		Output.Push(CurrentComponent->GetName());
-	}
-
 	return Output;
 }
 #endif
 
 UActorComponent* UEnhancedComponentReference::GetComponent(const UObject* InstancedObject) const
 {
-	if (Type.Get() == nullptr)
+	check(IsInGameThread());
+
+	UClass* ResolvedType{GetType()};
+	if (ResolvedType == nullptr)
 	{
+		// Components can't exist before their class is loaded, so a soft type that isn't loaded has nothing to find
+		if (!SoftType.IsNull())
+		{
+			return nullptr;
+		}
+
 		UE_LOG(
 			LogEnhancedComponentReference,
 			Warning,
@@ -161,14 +435,11 @@ UActorComponent* UEnhancedComponentReference::GetComponent(const UObject* Instan
 		return nullptr;
 	}
 
-	const AActor* Actor{nullptr};
-	if (InstancedObject->GetClass()->IsChildOf(UActorComponent::StaticClass()))
+	// Both casts only check the cast flags of the class, so actor owners get to the caches as fast as components
+	const AActor* Actor{Cast<AActor>(InstancedObject)};
+	if (const UActorComponent* Component{Cast<UActorComponent>(InstancedObject)}; Component != nullptr)
 	{
-		Actor = Cast<UActorComponent>(InstancedObject)->GetOwner();
-	}
-	else if (InstancedObject->GetClass()->IsChildOf(AActor::StaticClass()))
-	{
-		Actor = Cast<AActor>(InstancedObject);
+		Actor = Component->GetOwner();
 	}
 
 	if (Actor == nullptr)
@@ -180,61 +451,541 @@ UActorComponent* UEnhancedComponentReference::GetComponent(const UObject* Instan
 		return nullptr;
 	}
 
-	// Checking the C++ components
-	TArray<UActorComponent*> Components{};
-	Actor->GetComponents(Type, Components);
+	// Everything cached was resolved for a name and a type, changing either (from the details panel or from code at
+	// runtime) has to start over
+	if (ParsedPath != ComponentName || CachedType != TObjectKey<UClass>{ResolvedType})
+	{
+		ResetCaches();
+		ParsedPath = ComponentName;
+		CachedType = ResolvedType;
+		if (!SplitChildActorPath(ComponentName, ParsedChildActorComponent, ParsedComponent))
+		{
+			ParsedChildActorComponent = NAME_None;
+			ParsedComponent = NAME_None;
+		}
+	}
+
+	if (!ParsedChildActorComponent.IsNone())
+	{
+		return GetChildActorComponent(*Actor, *ResolvedType);
+	}
+
+	if (UActorComponent* Cached{FindCachedComponent(*Actor)}; Cached != nullptr)
+	{
+		return Cached;
+	}
+
+	if (UActorComponent* Baked{FilterInterface(FindBakedComponent(*Actor, *ResolvedType))}; Baked != nullptr)
+	{
+		CacheComponent(*Actor, Baked);
+		return Baked;
+	}
 
-	for (UActorComponent* CurrentComponent : Components)
+	// The guid still finds Blueprint components renamed after the reference got saved
+	if (ComponentGuid.IsValid())
 	{
-		if (CurrentComponent->GetName() == ComponentName)
+		const TSharedRef<const FEnhancedComponentIndex> Index{FEnhancedComponentIndex::Get(*Actor->GetClass())};
+		if (const FEnhancedComponentSlot* Slot{Index->FindByGuid(ComponentGuid)}; Slot != nullptr)
 		{
-			return CurrentComponent;
+			if (UActorComponent* Component{FEnhancedComponentIndex::Resolve(*Slot, *Actor)};
+				Component != nullptr && Component->IsA(ResolvedType) && FilterInterface(Component) != nullptr)
+			{
+				CacheComponent(*Actor, Component);
+				return Component;
+			}
 		}
 	}
 
-	// Checking the BP Components
-	const TArray<UActorComponent*> BPComponents{Actor->BlueprintCreatedComponents};
-	for (UActorComponent* CurrentComponent : BPComponents)
+	// Components added to a single placed actor aren't part of its class, so the plan would have to scan for them
+	if (UActorComponent* Instance{FindInstanceComponent(*Actor, *ResolvedType)}; Instance != nullptr)
+	{
+		CacheComponent(*Actor, Instance);
+		return Instance;
+	}
+
+	// The path to the component only depends on the class, so it gets compiled once and replayed from then on
+	UActorComponent* Output{FilterInterface(FEnhancedComponentPlanCache::Resolve(*Actor, ComponentName, ResolvedType))};
+	CacheComponent(*Actor, Output);
+
+	return Output;
+}
+
+void* UEnhancedComponentReference::GetInterfaceAddress(const UObject& InstancedObject) const
+{
+	UActorComponent* Component{GetComponent(&InstancedObject)};
+	if (Component == nullptr || InterfaceType == nullptr)
+	{
+		CachedInterfaceComponent.Reset();
+		CachedInterfaceAddress = nullptr;
+		return nullptr;
+	}
+
+	// The address only depends on the class of the component, so it stays valid for as long as the component does
+	if (CachedInterfaceComponent.Get() != Component)
 	{
-		if (CurrentComponent->GetName() == ComponentName)
+		CachedInterfaceComponent = Component;
+		CachedInterfaceAddress = Component->GetInterfaceAddress(InterfaceType);
+	}
+
+	return CachedInterfaceAddress;
+}
+
+TSharedPtr<FStreamableHandle> UEnhancedComponentReference::GetComponentAsync(
+	const UObject& InstancedObject,
+	FOnEnhancedComponentResolved OnResolved) const
+{
+	// Only the type is needed, resolving goes through the actor it is given and never reads the provided archetype
+	if (SoftType.IsNull())
+	{
+		OnResolved.ExecuteIfBound(GetComponent(&InstancedObject));
+		return nullptr;
+	}
+
+	// Either of them can be gone by the time the type is loaded
+	const TWeakObjectPtr<const UEnhancedComponentReference> WeakThis{this};
+	const TWeakObjectPtr<const UObject> WeakInstancedObject{&InstancedObject};
+
+	// The handle completes right away when the type was loaded already
+	return UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		SoftType.ToSoftObjectPath(),
+		FStreamableDelegate::CreateLambda([WeakThis, WeakInstancedObject, OnResolved = MoveTemp(OnResolved)]
+		{
+			const UEnhancedComponentReference* Reference{WeakThis.Get()};
+			const UObject* Object{WeakInstancedObject.Get()};
+			OnResolved.ExecuteIfBound(Reference != nullptr && Object != nullptr ? Reference->GetComponent(Object) : nullptr);
+		}));
+}
+
+void UEnhancedComponentReference::Serialize(FArchive& Ar)
+{
+	Ar.UsingCustomVersion(FEnhancedComponentReferenceVersion::GUID);
+
+	if (!UsesPackedRecord(Ar))
+	{
+		Super::Serialize(Ar);
+		return;
+	}
+
+	// The record replaces the whole of UObject::Serialize, the rest of it (the lazy pointer GUID, the memory counting)
+	// doesn't apply to the references
+	SerializePackedRecord(Ar);
+}
+
+void UEnhancedComponentReference::ForEachDeclaredReference(
+	const UClass& ActorClass,
+	const TFunctionRef<void(const UEnhancedComponentReference&)> Callback)
+{
+	TSet<const UEnhancedComponentReference*> Visited{};
+	const auto VisitSubobjects{
+		[&Visited, &Callback](const UObject* Outer)
 		{
-			if (!CurrentComponent->GetClass()->IsChildOf(Type))
+			if (Outer == nullptr)
 			{
-				continue;
+				return;
+			}
+
+			ForEachObjectWithOuter(Outer, [&Visited, &Callback](UObject* Object)
+			{
+				const UEnhancedComponentReference* Reference{Cast<UEnhancedComponentReference>(Object)};
+				if (Reference == nullptr || Visited.Contains(Reference))
+				{
+					return;
+				}
+
+				Visited.Add(Reference);
+				Callback(*Reference);
+			});
+		}
+	};
+
+	// The references of the C++ components (and of the actor itself) are subobjects of the CDO
+	VisitSubobjects(ActorClass.GetDefaultObject(false));
+
+	// The references of the Blueprint components are subobjects of their templates, which are the overrides of the
+	// class when the component is inherited and the class changed it
+	for (const FEnhancedComponentSlot& Slot : FEnhancedComponentIndex::Get(ActorClass)->GetSlots())
+	{
+		if (Slot.Kind == EEnhancedComponentSlotKind::Blueprint)
+		{
+			VisitSubobjects(Slot.Template.Get());
+		}
+	}
+}
+
+bool UEnhancedComponentReference::SplitChildActorPath(
+	const FName Path,
+	FName& OutChildActorComponent,
+	FName& OutComponent)
+{
+	FString ChildActorComponent{};
+	FString Component{};
+	if (!Path.ToString().Split(TEXT("."), &ChildActorComponent, &Component))
+	{
+		return false;
+	}
+
+	OutChildActorComponent = *ChildActorComponent;
+	OutComponent = *Component;
+	return true;
+}
+
+UActorComponent* UEnhancedComponentReference::GetChildActorComponent(const AActor& Actor, UClass& ResolvedType) const
+{
+	// Nothing changes until the child actor component respawns its actor (e.g. when its class gets changed)
+	if (CachedActor.Get() == &Actor)
+	{
+		const UChildActorComponent* ChildActorComponent{CachedChildActorComponent.Get()};
+		const AActor* ChildActor{CachedChildActor.Get()};
+		UActorComponent* Component{CachedComponent.Get()};
+		if (ChildActorComponent != nullptr && ChildActor != nullptr && ChildActorComponent->GetChildActor() == ChildActor
+			&& Component != nullptr && Component->GetOwner() == ChildActor)
+		{
+			return Component;
+		}
+	}
+
+	UChildActorComponent* ChildActorComponent{
+		Cast<UChildActorComponent>(
+			FEnhancedComponentPlanCache::Resolve(Actor, ParsedChildActorComponent, UChildActorComponent::StaticClass()))
+	};
+	const AActor* ChildActor{ChildActorComponent != nullptr ? ChildActorComponent->GetChildActor() : nullptr};
+	if (ChildActor == nullptr)
+	{
+		return nullptr;
+	}
+
+	// The child actor has a class of its own, so it gets its own plans
+	UActorComponent* Output{
+		FilterInterface(FEnhancedComponentPlanCache::Resolve(*ChildActor, ParsedComponent, &ResolvedType))
+	};
+	if (Output == nullptr)
+	{
+		return nullptr;
+	}
+
+	CachedActor = &Actor;
+	CachedComponent = Output;
+	CachedChildActorComponent = ChildActorComponent;
+	CachedChildActor = ChildActor;
+	CachedArchetype.Reset();
+	CachedBlueprintIndex = INDEX_NONE;
+
+	return Output;
+}
+
+UActorComponent* UEnhancedComponentReference::FindCachedComponent(const AActor& Actor) const
+{
+	if (CachedActor.Get() != &Actor)
+	{
+		return nullptr;
+	}
+
+	// Pooled actors keep their components between uses, so reacquiring one from the pool ends here
+	if (UActorComponent* Component{CachedComponent.Get()}; Component != nullptr && Component->GetOwner() == &Actor)
+	{
+		return Component;
+	}
+
+	// The component was destroyed, if it was by a rerun of the construction script the new one will be in the same
+	// position and will have been created from the same template, so there is no need to go through the plans again
+	const UObject* Archetype{CachedArchetype.Get()};
+	if (Archetype == nullptr || !Actor.BlueprintCreatedComponents.IsValidIndex(CachedBlueprintIndex))
+	{
+		return nullptr;
+	}
+
+	UActorComponent* Recreated{Actor.BlueprintCreatedComponents[CachedBlueprintIndex]};
+	if (!IsValid(Recreated) || Recreated->GetArchetype() != Archetype || Recreated->GetFName() != ComponentName)
+	{
+		return nullptr;
+	}
+
+	CachedComponent = Recreated;
+	return Recreated;
+}
+
+bool UEnhancedComponentReference::UsesPackedRecord(const FArchive& Ar)
+{
+	// Only the packages with the editor data stripped get it, which are the same ones when saving and loading
+	if (!Ar.IsPersistent() || !Ar.IsFilterEditorOnly() || Ar.IsTransacting() || Ar.IsCountingMemory())
+	{
+		return false;
+	}
+
+	return Ar.IsSaving() || Ar.CustomVer(FEnhancedComponentReferenceVersion::GUID) >=
+		FEnhancedComponentReferenceVersion::PackedCookedRecord;
+}
+
+void UEnhancedComponentReference::SerializePackedRecord(FArchive& Ar)
+{
+	// The position only has to be worked out when cooking, by then the class index of the owner is complete
+	if (Ar.IsSaving())
+	{
+		BakedIndex = INDEX_NONE;
+		bBakedInstanceComponent = false;
+
+		if (const UClass* OwnerClass{FindOwnerClass()}; OwnerClass != nullptr && GetType() != nullptr)
+		{
+			const FEnhancedComponentResolutionPlan Plan{
+				FEnhancedComponentPlanCache::Compile(*OwnerClass, ComponentName, GetType())
+			};
+			if (Plan.Step != EEnhancedComponentPlanStep::TypeMismatch &&
+				Plan.Slot.Kind == EEnhancedComponentSlotKind::Blueprint)
+			{
+				BakedIndex = Plan.Slot.BlueprintIndex;
+			}
+		}
+
+		// References on placed actors can also point to the components added to that single actor
+		const AActor* Instance{not bUseOtherAsset ? FindOwnerInstance() : nullptr};
+		if (BakedIndex == INDEX_NONE && Instance != nullptr && GetType() != nullptr)
+		{
+			for (const FEnhancedComponentSlot& Slot : FEnhancedComponentIndex::GetInstanceSlots(*Instance))
+			{
+				if (const UClass* ComponentClass{Slot.ComponentClass.Get()};
+					Slot.Name == ComponentName && ComponentClass != nullptr && ComponentClass->IsChildOf(GetType()))
+				{
+					BakedIndex = Slot.InstanceIndex;
+					bBakedInstanceComponent = true;
+					break;
+				}
 			}
-			return CurrentComponent;
+		}
+	}
+
+	// The placed actors almost never change their references, and their properties already come from the archetype
+	// when they get constructed, so only the flags get written for them like the tagged properties would do
+	const UEnhancedComponentReference* Archetype{Cast<UEnhancedComponentReference>(GetArchetype())};
+	if (Ar.IsSaving() && MatchesArchetype(Archetype))
+	{
+		EPackedRecordFlags Flags{EPackedRecordFlags::MatchesArchetype};
+		Ar << Flags;
+		return;
+	}
+
+	EPackedRecordFlags Flags{bUseOtherAsset ? EPackedRecordFlags::UseOtherAsset : EPackedRecordFlags::None};
+	if (!SoftType.IsNull())
+	{
+		Flags |= EPackedRecordFlags::SoftType;
+	}
+	if (bBakedInstanceComponent)
+	{
+		Flags |= EPackedRecordFlags::BakedInstanceComponent;
+	}
+	if (InterfaceType != nullptr)
+	{
+		Flags |= EPackedRecordFlags::Interface;
+	}
+	Ar << Flags;
+
+	if (Ar.CustomVer(FEnhancedComponentReferenceVersion::GUID) >= FEnhancedComponentReferenceVersion::ArchetypeDelta
+		&& EnumHasAnyFlags(Flags, EPackedRecordFlags::MatchesArchetype))
+	{
+		// The position isn't a property, so it doesn't come with the rest. The archetype is in an import of the package,
+		// which is done loading by now
+		if (Archetype != nullptr)
+		{
+			BakedIndex = Archetype->BakedIndex;
+			bBakedInstanceComponent = false;
+		}
+		return;
+	}
+
+	bUseOtherAsset = EnumHasAnyFlags(Flags, EPackedRecordFlags::UseOtherAsset);
+	bBakedInstanceComponent = EnumHasAnyFlags(Flags, EPackedRecordFlags::BakedInstanceComponent);
+
+	// Both end up as indices into the name and import tables of the package (the soft types into the soft paths so
+	// that they don't become a dependency of the package)
+	Ar << ComponentName;
+	if (EnumHasAnyFlags(Flags, EPackedRecordFlags::SoftType))
+	{
+		Ar << SoftType;
+	}
+	else
+	{
+		Ar << Type;
+	}
+
+	// Shifted by one so that INDEX_NONE fits in the single byte the usual positions take
+	uint32 PackedIndex{static_cast<uint32>(BakedIndex + 1)};
+	Ar.SerializeIntPacked(PackedIndex);
+	BakedIndex = static_cast<int32>(PackedIndex) - 1;
+
+	if (bUseOtherAsset)
+	{
+		if (const int32 Version{Ar.CustomVer(FEnhancedComponentReferenceVersion::GUID)};
+			Version >= FEnhancedComponentReferenceVersion::SoftProvidedArchetype)
+		{
+			Ar << ProvidedArchetype;
+		}
+		else
+		{
+			// The records cooked before the archetype went soft have it as an import of the class
+			UClass* HardArchetype{nullptr};
+			Ar << HardArchetype;
+			ProvidedArchetype = HardArchetype;
+		}
+	}
+
+	// Appended so that the records cooked before the interfaces existed still read the same
+	if (Ar.CustomVer(FEnhancedComponentReferenceVersion::GUID) >= FEnhancedComponentReferenceVersion::InterfaceFilter
+		&& EnumHasAnyFlags(Flags, EPackedRecordFlags::Interface))
+	{
+		Ar << InterfaceType;
+	}
+}
+
+bool UEnhancedComponentReference::MatchesArchetype(const UEnhancedComponentReference* Archetype) const
+{
+	if (Archetype == nullptr || Archetype == this || bBakedInstanceComponent)
+	{
+		return false;
+	}
+
+	// The position is taken from the archetype when loading, so both have to be baked against the same class
+	return ComponentName == Archetype->ComponentName && Type == Archetype->Type && SoftType == Archetype->SoftType
+		&& InterfaceType == Archetype->InterfaceType && bUseOtherAsset == Archetype->bUseOtherAsset
+		&& ProvidedArchetype == Archetype->ProvidedArchetype && FindOwnerClass() == Archetype->FindOwnerClass();
+}
+
+const UClass* UEnhancedComponentReference::FindOwnerClass() const
+{
+	// The archetype isn't loaded just for baking the position, it is usually loaded by then anyway
+	if (bUseOtherAsset)
+	{
+		return ProvidedArchetype.Get();
+	}
+
+	// The outers are the component (or its template), then the actor or its class. Templates overridden by a child
+	// Blueprint have the handler of the overrides in between
+	for (const UObject* Outer{GetOuter()}; Outer != nullptr; Outer = Outer->GetOuter())
+	{
+		if (const UClass* Class{Cast<UClass>(Outer)}; Class != nullptr)
+		{
+			return Class->IsChildOf(AActor::StaticClass()) ? Class : nullptr;
+		}
+
+		if (Outer->IsA<AActor>())
+		{
+			return Outer->GetClass();
 		}
 	}
 
 	return nullptr;
 }
 
-const AActor* UEnhancedComponentReference::ObjToActor(const UObject* Object)
+const AActor* UEnhancedComponentReference::FindOwnerInstance() const
 {
-	// Handling the cases where the class was made in c++
-	if (const AActor* Actor{Cast<AActor>(Object)}; Actor != nullptr)
+	for (const UObject* Outer{GetOuter()}; Outer != nullptr; Outer = Outer->GetOuter())
 	{
-		return Actor;
+		if (Outer->IsA<UClass>())
+		{
+			return nullptr;
+		}
+
+		if (const AActor* Actor{Cast<AActor>(Outer)}; Actor != nullptr)
+		{
+			return Actor->IsTemplate() ? nullptr : Actor;
+		}
 	}
 
-#if WITH_EDITOR
-	if (const UBlueprintGeneratedClass* BPClass{Cast<UBlueprintGeneratedClass>(Object)}; BPClass != nullptr)
+	return nullptr;
+}
+
+UActorComponent* UEnhancedComponentReference::FindBakedComponent(const AActor& Actor, const UClass& ResolvedType) const
+{
+	UActorComponent* Component{nullptr};
+	if (bBakedInstanceComponent)
+	{
+		// The instance components are saved with the level, so they keep their order
+		if (const TArray<UActorComponent*>& InstanceComponents{Actor.GetInstanceComponents()};
+			InstanceComponents.IsValidIndex(BakedIndex))
+		{
+			Component = InstanceComponents[BakedIndex];
+		}
+	}
+	else if (Actor.BlueprintCreatedComponents.IsValidIndex(BakedIndex))
+	{
+		// Child Blueprints add their components after the ones of their parents, so the position holds for them too
+		Component = Actor.BlueprintCreatedComponents[BakedIndex];
+	}
+
+	if (!IsValid(Component) || Component->GetFName() != ComponentName || !Component->IsA(&ResolvedType))
+	{
+		return nullptr;
+	}
+
+	return Component;
+}
+
+UActorComponent* UEnhancedComponentReference::FindInstanceComponent(
+	const AActor& Actor,
+	const UClass& ResolvedType) const
+{
+	// Only the placed actor the reference is declared on can have components its class doesn't know about
+	if (bUseOtherAsset || FindOwnerInstance() != &Actor ||
+		FEnhancedComponentIndex::Get(*Actor.GetClass())->Find(ComponentName) != nullptr)
 	{
-		// Traversing all the way up the chain of operations for the 
-		const UBlueprint* Generator{Cast<UBlueprint>(BPClass->ClassGeneratedBy)};
-		const UClass* ParentClass{Cast<UClass>(Generator->ParentClass)};
+		return nullptr;
+	}
 
-		while (ParentClass && not ParentClass->IsNative())
+	for (const FEnhancedComponentSlot& Slot : FEnhancedComponentIndex::GetInstanceSlots(Actor))
+	{
+		if (Slot.Name != ComponentName)
 		{
-			ParentClass = ParentClass->GetSuperClass();
+			continue;
 		}
 
-		return Cast<AActor>(ParentClass->GetDefaultObject());
+		UActorComponent* Component{FEnhancedComponentIndex::Resolve(Slot, Actor)};
+		return Component != nullptr && Component->IsA(&ResolvedType) ? FilterInterface(Component) : nullptr;
 	}
-#endif
 
-	// NOTE: If there are other cases where we need to find the default object,
-	// but we can't with any method implemented above, expand the implementation here
+	return nullptr;
+}
+
+UActorComponent* UEnhancedComponentReference::FilterInterface(UActorComponent* Component) const
+{
+	if (Component == nullptr || InterfaceType == nullptr || Component->GetClass()->ImplementsInterface(InterfaceType))
+	{
+		return Component;
+	}
 
 	return nullptr;
 }
+
+bool UEnhancedComponentReference::AcceptsClass(const UClass& ComponentClass, const UClass* FilterType) const
+{
+	return ComponentClass.IsChildOf(FilterType) &&
+		(InterfaceType == nullptr || ComponentClass.ImplementsInterface(InterfaceType));
+}
+
+void UEnhancedComponentReference::ResetCaches() const
+{
+	CachedActor.Reset();
+	CachedComponent.Reset();
+	CachedArchetype.Reset();
+	CachedBlueprintIndex = INDEX_NONE;
+	CachedChildActorComponent.Reset();
+	CachedChildActor.Reset();
+	CachedInterfaceComponent.Reset();
+	CachedInterfaceAddress = nullptr;
+
+	// Forces the name to be parsed again on the next get
+	ParsedPath = NAME_None;
+	ParsedChildActorComponent = NAME_None;
+	ParsedComponent = NAME_None;
+	CachedType = {};
+}
+
+void UEnhancedComponentReference::CacheComponent(const AActor& Actor, UActorComponent* Component) const
+{
+	if (Component == nullptr)
+	{
+		return;
+	}
+
+	CachedActor = &Actor;
+	CachedComponent = Component;
+	CachedArchetype = Component->GetArchetype();
+	CachedBlueprintIndex = Actor.BlueprintCreatedComponents.Find(Component);
+}
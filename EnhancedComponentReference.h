@@ -12,13 +12,53 @@
 
 #include "CoreMinimal.h"
 #include "UObject/Object.h"
+#include "UObject/ScriptInterface.h"
+#include "UObject/SoftObjectPtr.h"
 #include "EnhancedComponentReference.generated.h"
 
+class UChildActorComponent;
+struct FStreamableHandle;
+
 template <typename T>
 concept ComponentClass = std::is_base_of_v<UActorComponent, T>;
 
+/** Native side of a UInterface (the IDamageable of UDamageable) */
+template <typename T>
+concept InterfaceClass = std::is_base_of_v<UInterface, typename T::UClassType>;
+
 DECLARE_LOG_CATEGORY_CLASS(LogEnhancedComponentReference, Warning, Warning)
 
+/** Called with the component once an async resolution finishes, null if it couldn't be found */
+DECLARE_DELEGATE_OneParam(FOnEnhancedComponentResolved, UActorComponent*);
+
+/**
+ * @brief Versions of the packed record written for the references in cooked packages.
+ */
+struct IDOLONDUTY_API FEnhancedComponentReferenceVersion
+{
+	enum Type
+	{
+		BeforeCustomVersionWasAdded = 0,
+
+		/** Cooked packages store the packed record instead of the tagged properties */
+		PackedCookedRecord,
+
+		/** The packed record stores ProvidedArchetype as a soft path instead of an import of the class */
+		SoftProvidedArchetype,
+
+		/** The instances matching their archetype only store the flags of the record */
+		ArchetypeDelta,
+
+		/** The record stores the interface the component has to implement */
+		InterfaceFilter,
+
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	static const FGuid GUID;
+};
+
 /**
  * @brief Type to refer to another component in the same actor.
  * This allows for C++ to get references to BP added components.
@@ -50,13 +90,71 @@ public:
 	 */
 	template <ComponentClass T>
 	[[nodiscard]] static UEnhancedComponentReference* Create(UObject& Owner, const FName Name = "");
+
+	/**
+	 * @brief Factory method for an enhanced reference to an optional component type (CONSTRUCTOR ONLY). The type
+	 * isn't loaded with the owner, the reference only finds components once something else loaded their class
+	 * @param Type The type that this reference will work with
+	 * @param Owner The owner of this reference (almost always it should be this)
+	 * @param Name The name of the reference in the editor
+	 * @return Pointer to the new reference
+	 */
+	[[nodiscard]] static UEnhancedComponentReference* CreateSoft(
+		const TSoftClassPtr<UActorComponent>& Type,
+		UObject* Owner,
+		const FName Name = "");
+
+	/**
+	 * @brief Factory method for an enhanced reference to any component implementing an interface (CONSTRUCTOR ONLY)
+	 * @param Interface The interface the component has to implement
+	 * @param Owner The owner of this reference (almost always it should be this)
+	 * @param Name The name of the reference in the editor
+	 * @return Pointer to the new reference
+	 */
+	[[nodiscard]] static UEnhancedComponentReference* CreateInterface(
+		const TSubclassOf<UInterface> Interface,
+		UObject* Owner,
+		const FName Name = "");
+
+	/**
+	 * @brief Factory method for an enhanced reference to any component implementing an interface (CONSTRUCTOR ONLY)
+	 * @tparam T The interface the component has to implement (IDamageable, not UDamageable)
+	 * @param Owner The owner of this reference (almost always it should be this)
+	 * @return Pointer to the new reference
+	 */
+	template <InterfaceClass T>
+	[[nodiscard]] static UEnhancedComponentReference* CreateInterface(UObject& Owner, const FName Name = "");
 	
+	/**
+	 * Name of the component, or "ChildActorComponentName.ComponentName" for a component of the actor spawned by a
+	 * child actor component
+	 */
 	UPROPERTY(EditAnywhere, meta=(GetOptions="GetAvailableComponentNames"))
 	FName ComponentName;
 
+	/**
+	 * VariableGuid of the node of the Blueprint component, so that renaming the component doesn't break the
+	 * reference. The name is kept for display and for the C++ components, and it follows the guid when saving
+	 */
+	UPROPERTY()
+	FGuid ComponentGuid;
+
 	UPROPERTY(VisibleAnywhere)
 	TSubclassOf<UActorComponent> Type;
 
+	/**
+	 * Used instead of Type by the references created with CreateSoft
+	 */
+	UPROPERTY(VisibleAnywhere)
+	TSoftClassPtr<UActorComponent> SoftType;
+
+	/**
+	 * Interface the component has to implement on top of being of the type, set by the references created with
+	 * CreateInterface
+	 */
+	UPROPERTY(VisibleAnywhere)
+	TSubclassOf<UInterface> InterfaceType;
+
 	// TODO: Store the default archetype to be able to tell whether the object provided for getting the component
 	// is of the type said at creation
 	// UPROPERTY(VisibleAnywhere)
@@ -70,20 +168,47 @@ public:
 	bool bUseOtherAsset{false};
 
 	/**
-	 * The Archetype to look into for the reference name
+	 * The Archetype to look into for the reference name. This is soft so that the owner doesn't drag the whole
+	 * Blueprint (and its meshes and materials) into memory with it, nothing at runtime needs it loaded
 	 */
 	UPROPERTY(EditDefaultsOnly, meta=(EditCondition="bUseOtherAsset"))
-	TSubclassOf<AActor> ProvidedArchetype;
+	TSoftClassPtr<AActor> ProvidedArchetype;
+
+#if WITH_EDITORONLY_DATA
+	/**
+	 * Whether the component is only created at runtime (by gameplay code), so the audit doesn't expect the class to
+	 * have it
+	 */
+	UPROPERTY(EditAnywhere)
+	bool bAddedAtRuntime{false};
+#endif
 
 #if WITH_EDITOR
+	/**
+	 * @brief Options for the dropdown of ComponentName, these are cached until the Blueprint changes or recompiles.
+	 */
 	UFUNCTION()
 	[[nodiscard]] TArray<FString> GetAvailableComponentNames() const;
 #endif
 
+	/**
+	 * @brief Gets the type of the reference without loading it.
+	 * @return The type, null if it isn't set or if it is soft and not loaded yet
+	 */
+	[[nodiscard]] UClass* GetType() const;
+
+	/**
+	 * @brief Gets the type of the reference, loading it if it is soft. This blocks, so it is meant for the editor and
+	 * the commandlets.
+	 */
+	[[nodiscard]] UClass* LoadType() const;
+
 	// TODO: Check whether the provided UObject is of the type that was used at declaration time
 	
 	/**
 	 * @brief This is the getter for the component that has been referenced.
+	 * This never loads anything, soft types that aren't loaded yet give null (see GetComponentAsync).
+	 * Game thread only, the caches of the reference and the shared class indices aren't synchronized.
 	 * @param InstancedObject The owner that we should be fetching from. This should be the instance that was created from the blueprint
 	 * @return Pointer to the component
 	 */
@@ -99,8 +224,195 @@ public:
 	template <ComponentClass T>
 	[[nodiscard]] TOptional<T*> GetComponent(const UObject& InstancedObject) const;
 
+	/**
+	 * @brief Gets the address of the InterfaceType of the component, this is kept with the component so that the
+	 * interface only gets looked up when the component changes.
+	 * @param InstancedObject The owner that we should be fetching from
+	 * @return The address, null if the component wasn't found or if the interface is only implemented in Blueprint
+	 */
+	[[nodiscard]] void* GetInterfaceAddress(const UObject& InstancedObject) const;
+
+	/**
+	 * @brief This is the getter for the interface of the component that has been referenced.
+	 * @tparam T The interface to get (IDamageable, not UDamageable)
+	 * @param InstancedObject The owner that we should be fetching from
+	 * @return The component and its interface, the interface is null if the interface is only implemented in
+	 * Blueprint (use the Execute_ functions then)
+	 */
+	template <InterfaceClass T>
+	[[nodiscard]] TScriptInterface<T> GetInterface(const UObject& InstancedObject) const;
+
+	/**
+	 * @brief Gets the component once the soft type of the reference is loaded, this is requested through the
+	 * streamable manager instead of blocking the game thread.
+	 * @param InstancedObject The owner that we should be fetching from
+	 * @param OnResolved Called with the component, right away if there was nothing to load
+	 * @return Handle of the load (the type stays loaded while it is kept), null if there was nothing to load
+	 */
+	TSharedPtr<FStreamableHandle> GetComponentAsync(
+		const UObject& InstancedObject,
+		FOnEnhancedComponentResolved OnResolved) const;
+
+	/**
+	 * @brief Cooked packages get a packed record with only what the runtime reads (the name, the classes and the
+	 * position of the component baked when cooking), everything else goes through the tagged properties.
+	 */
+	virtual void Serialize(FArchive& Ar) override;
+
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
+
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/**
+	 * @brief Goes through the references declared by an actor class, both the ones in its CDO and the ones in the
+	 * templates of its Blueprint components.
+	 * @param ActorClass The class to look into
+	 * @param Callback Called once for each reference, the outer of the reference is the object declaring it
+	 */
+	static void ForEachDeclaredReference(
+		const UClass& ActorClass,
+		TFunctionRef<void(const UEnhancedComponentReference&)> Callback);
+
+	/**
+	 * @brief Splits a "ChildActorComponentName.ComponentName" path, only one level of child actors is supported.
+	 * @return Whether the name was a path into a child actor
+	 */
+	static bool SplitChildActorPath(const FName Path, FName& OutChildActorComponent, FName& OutComponent);
+
 private:
-	static const AActor* ObjToActor(const UObject* Object);
+#if WITH_EDITOR
+	/**
+	 * @brief Gets the names of the components of the class, and the paths into the components of its child actors.
+	 * @param Outer The class to look into
+	 * @param OutChildActorClasses The classes of the child actors that were looked into
+	 */
+	[[nodiscard]] TArray<FString> CollectAvailableComponentNames(
+		const UObject& Outer,
+		TArray<const UClass*>& OutChildActorClasses) const;
+
+	/**
+	 * @brief Adds the names of the components added to the placed actor owning the reference, if it has one.
+	 */
+	[[nodiscard]] TArray<FString> AppendInstanceComponentNames(TArray<FString> Names) const;
+
+	/**
+	 * @brief Brings the name and the guid back in sync, the guid wins if its component still exists (it got renamed),
+	 * otherwise the guid gets taken from the component with the name.
+	 */
+	void SyncComponentGuid();
+#endif
+
+	/**
+	 * @brief Gets the component through the child actor component, keeping both for as long as the child actor
+	 * isn't respawned.
+	 */
+	[[nodiscard]] UActorComponent* GetChildActorComponent(const AActor& Actor, UClass& ResolvedType) const;
+
+	/**
+	 * @brief Gets the component resolved by the last call if it still belongs to the actor.
+	 * @param Actor The actor that is being looked into
+	 * @return The component or null if the cache doesn't hold anything valid for the actor
+	 */
+	[[nodiscard]] UActorComponent* FindCachedComponent(const AActor& Actor) const;
+
+	void CacheComponent(const AActor& Actor, UActorComponent* Component) const;
+
+	/**
+	 * @brief Forgets everything resolved so far, for when the name or the type of the reference change.
+	 */
+	void ResetCaches() const;
+
+	/**
+	 * @brief Whether the archive reads or writes the packed record, this has to give the same answer when saving and
+	 * when loading the same package.
+	 */
+	[[nodiscard]] static bool UsesPackedRecord(const FArchive& Ar);
+
+	void SerializePackedRecord(FArchive& Ar);
+
+	/**
+	 * @brief Whether the packed record would be the same as the one of the archetype, so that it doesn't have to be
+	 * written again for the instance. This has to be called after baking the position.
+	 */
+	[[nodiscard]] bool MatchesArchetype(const UEnhancedComponentReference* Archetype) const;
+
+	/**
+	 * @brief Gets the class of the actor that will own the component, going through the outers of the reference. The
+	 * reference can be declared on the actor itself or on one of its components (C++, Blueprint or placed instance).
+	 */
+	[[nodiscard]] const UClass* FindOwnerClass() const;
+
+	/**
+	 * @brief Gets the placed actor owning the reference, null when the reference belongs to a class (declared on its
+	 * CDO or on one of its component templates).
+	 */
+	[[nodiscard]] const AActor* FindOwnerInstance() const;
+
+	/**
+	 * @brief Gets the component at the position baked when cooking if it is still the one being referenced.
+	 */
+	[[nodiscard]] UActorComponent* FindBakedComponent(const AActor& Actor, const UClass& ResolvedType) const;
+
+	/**
+	 * @brief Gets the component through the instance slots of the placed actor owning the reference, for the components
+	 * added to that actor alone when nothing got baked (uncooked sessions).
+	 */
+	[[nodiscard]] UActorComponent* FindInstanceComponent(const AActor& Actor, const UClass& ResolvedType) const;
+
+	/**
+	 * @brief Gives back the component if it implements the InterfaceType (or if there isn't one), null otherwise.
+	 */
+	[[nodiscard]] UActorComponent* FilterInterface(UActorComponent* Component) const;
+
+	/**
+	 * @brief Whether components of the class can be referenced, this is the filter of the dropdown.
+	 */
+	[[nodiscard]] bool AcceptsClass(const UClass& ComponentClass, const UClass* FilterType) const;
+
+	/** Actor the cached component was resolved against */
+	mutable TWeakObjectPtr<const AActor> CachedActor;
+
+	mutable TWeakObjectPtr<UActorComponent> CachedComponent;
+
+	/**
+	 * Template of the cached component. The construction scripts destroy and create the Blueprint components again
+	 * (in the editor this happens on every drag), and the new component shares the template of the old one.
+	 */
+	mutable TWeakObjectPtr<const UObject> CachedArchetype;
+
+	/** Position of the cached component in BlueprintCreatedComponents, INDEX_NONE for C++ components */
+	mutable int32 CachedBlueprintIndex{INDEX_NONE};
+
+	/** Child actor component and child actor the cached component was found through, for the child actor paths */
+	mutable TWeakObjectPtr<UChildActorComponent> CachedChildActorComponent;
+	mutable TWeakObjectPtr<const AActor> CachedChildActor;
+
+	/** ComponentName the parsed names and the caches come from, so that the path only gets split when it changes */
+	mutable FName ParsedPath;
+
+	/** Type the caches were resolved for */
+	mutable TObjectKey<UClass> CachedType;
+
+	/** Child actor component of the path, None when ComponentName isn't a path */
+	mutable FName ParsedChildActorComponent;
+
+	/** Component of the child actor of the path */
+	mutable FName ParsedComponent;
+
+	/**
+	 * Position of the component baked when cooking, INDEX_NONE if it wasn't known. This is a position in
+	 * BlueprintCreatedComponents, or in the instance components when bBakedInstanceComponent is set
+	 */
+	int32 BakedIndex{INDEX_NONE};
+
+	bool bBakedInstanceComponent{false};
+
+	/** Component the cached interface address belongs to */
+	mutable TWeakObjectPtr<UActorComponent> CachedInterfaceComponent;
+
+	mutable void* CachedInterfaceAddress{nullptr};
 };
 
 template <ComponentClass T>
@@ -118,70 +430,59 @@ UEnhancedComponentReference* UEnhancedComponentReference::Create(UObject& Owner,
 	return Output;
 }
 
-template <ComponentClass T>
-TOptional<T*> UEnhancedComponentReference::GetComponent(const UObject& InstancedObject) const
+template <InterfaceClass T>
+UEnhancedComponentReference* UEnhancedComponentReference::CreateInterface(UObject& Owner, const FName Name)
 {
-	if (Type.Get() == nullptr)
+	FName ToAssign{T::UClassType::StaticClass()->GetName() + TEXT("_Ref")};
+	if (not Name.IsNone())
 	{
-		UE_LOG(
-			LogEnhancedComponentReference,
-			Warning,
-			TEXT(
-				"The type is not valid (are you creating the reference in the constructor?, if so, try resetting the value to it's default)"
-			));
-		return nullptr;
+		ToAssign = Name;
 	}
 
-	const AActor* Actor{nullptr};
-	if (InstancedObject.GetClass()->IsChildOf(UActorComponent::StaticClass()))
-	{
-		Actor = Cast<UActorComponent>(&InstancedObject)->GetOwner();
-	}
-	else if (InstancedObject.GetClass()->IsChildOf(AActor::StaticClass()))
-	{
-		Actor = Cast<AActor>(&InstancedObject);
-	}
+	UEnhancedComponentReference* Output{Owner.CreateDefaultSubobject<UEnhancedComponentReference>(ToAssign)};
+	Output->Type = UActorComponent::StaticClass();
+	Output->InterfaceType = T::UClassType::StaticClass();
 
-	if (Actor == nullptr)
+	return Output;
+}
+
+template <ComponentClass T>
+TOptional<T*> UEnhancedComponentReference::GetComponent(const UObject& InstancedObject) const
+{
+	// Both getters share the same lookup (class index first, then the scans)
+	T* Output{Cast<T>(GetComponent(&InstancedObject))};
+	if (Output == nullptr)
 	{
-		UE_LOG(
-			LogEnhancedComponentReference,
-			Warning,
-			TEXT("There is no valid owner to get the components"));
-		return {};
+		return NullOpt;
 	}
 
-	// Checking the C++ components
-	TArray<T*> Components{};
-	Actor->GetComponents(Type, Components);
+	return Output;
+}
+
+template <InterfaceClass T>
+TScriptInterface<T> UEnhancedComponentReference::GetInterface(const UObject& InstancedObject) const
+{
+	TScriptInterface<T> Output{};
 
-	for (T* CurrentComponent : Components)
+	// The cached address is the one of the InterfaceType, any other interface goes through the regular cast
+	if (InterfaceType.Get() != T::UClassType::StaticClass())
 	{
-		if (CurrentComponent->GetName() == ComponentName)
+		UActorComponent* Component{GetComponent(&InstancedObject)};
+		if (Component != nullptr && Component->GetClass()->ImplementsInterface(T::UClassType::StaticClass()))
 		{
-			T* Output = Cast<T>(CurrentComponent);
-			if (Output == nullptr)
-			{
-				continue;
-			}
-			return Output;
+			Output.SetObject(Component);
+			Output.SetInterface(Cast<T>(Component));
 		}
+
+		return Output;
 	}
 
-	// Checking the BP components
-	const TArray<UActorComponent*> BPComponents{Actor->BlueprintCreatedComponents};
-	for (UActorComponent* CurrentComponent : BPComponents)
+	void* Address{GetInterfaceAddress(InstancedObject)};
+	if (UActorComponent* Component{CachedInterfaceComponent.Get()}; Component != nullptr)
 	{
-		if (CurrentComponent->GetName() == ComponentName)
-		{
-			T* Output = Cast<T>(CurrentComponent);
-			if (Output == nullptr)
-			{
-				continue;
-			}
-			return Output;
-		}
+		Output.SetObject(Component);
+		Output.SetInterface(static_cast<T*>(Address));
 	}
 
-	return NullOpt;
+	return Output;
 }
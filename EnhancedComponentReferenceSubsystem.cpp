@@ -0,0 +1,841 @@
+﻿/**
+ * @file EnhancedComponentReferenceSubsystem.cpp
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Implementation of the subsystem notifying when the components of the references show up.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#include "Utilities/Property/EnhancedComponentReferenceSubsystem.h"
+
+#include "Utilities/Property/EnhancedComponentIndex.h"
+#include "Utilities/Property/EnhancedComponentReference.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/UObjectArray.h"
+#include "UObject/UObjectHash.h"
+
+namespace
+{
+	TAutoConsoleVariable<float> CVarPrewarmBudget{
+		TEXT("EnhancedComponentReference.PrewarmBudgetMs"),
+		1.0f,
+		TEXT("Time per frame spent resolving the references of the streamed in levels ahead of their first tick")
+	};
+
+	const AActor* FindActor(const UObject& InstancedObject)
+	{
+		if (const UActorComponent* Component{Cast<UActorComponent>(&InstancedObject)}; Component != nullptr)
+		{
+			return Component->GetOwner();
+		}
+
+		return Cast<AActor>(&InstancedObject);
+	}
+}
+
+class UEnhancedComponentReferenceSubsystem::FCreateListener final : public FUObjectArray::FUObjectCreateListener
+{
+public:
+	virtual ~FCreateListener() override
+	{
+		Stop();
+	}
+
+	/**
+	 * @brief Sets the actors to listen for, it stops listening when there are none.
+	 * @param Actors The actors whose new components count as a change
+	 * @param bAnyActor Whether the creation of any actor counts as a change too, for the paths into child actors
+	 */
+	void Watch(TSet<const UObjectBase*>&& Actors, const bool bAnyActor)
+	{
+		const bool bListen{!Actors.IsEmpty()};
+		{
+			FScopeLock Lock{&CriticalSection};
+			WatchedActors = MoveTemp(Actors);
+			bWatchAnyActor = bAnyActor;
+		}
+
+		if (bListen && !bListening)
+		{
+			GUObjectArray.AddUObjectCreateListener(this);
+			bListening = true;
+		}
+		else if (!bListen)
+		{
+			Stop();
+		}
+	}
+
+	/**
+	 * @brief Takes the actors that got components created since the last call.
+	 * @return Whether any actor got created since the last call (only while bAnyActor is set)
+	 */
+	bool TakeChanges(TSet<const UObjectBase*>& OutChangedActors)
+	{
+		FScopeLock Lock{&CriticalSection};
+		OutChangedActors = MoveTemp(ChangedActors);
+		ChangedActors.Reset();
+
+		const bool bOutput{bActorCreated};
+		bActorCreated = false;
+		return bOutput;
+	}
+
+	virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override
+	{
+		// Called from whichever thread creates the object (the async loading one included), before its constructor
+		// runs, but the outer and the class are already set
+		FScopeLock Lock{&CriticalSection};
+		if (const UObjectBase* Outer{Object->GetOuter()}; Outer != nullptr && WatchedActors.Contains(Outer))
+		{
+			ChangedActors.Add(Outer);
+		}
+		else if (bWatchAnyActor && Object->GetClass()->IsChildOf(AActor::StaticClass()))
+		{
+			bActorCreated = true;
+		}
+	}
+
+	virtual void OnUObjectArrayShutdown() override
+	{
+		Stop();
+	}
+
+private:
+	void Stop()
+	{
+		if (bListening)
+		{
+			GUObjectArray.RemoveUObjectCreateListener(this);
+			bListening = false;
+		}
+	}
+
+	FCriticalSection CriticalSection;
+
+	/** Only compared against the outers, so an actor that went away can at most cause an extra check */
+	TSet<const UObjectBase*> WatchedActors;
+
+	TSet<const UObjectBase*> ChangedActors;
+
+	bool bWatchAnyActor{false};
+
+	bool bActorCreated{false};
+
+	/** Only touched from the game thread */
+	bool bListening{false};
+};
+
+FDelegateHandle UEnhancedComponentReferenceSubsystem::AddOnComponentAvailable(
+	const UEnhancedComponentReference& Reference,
+	const UObject& InstancedObject,
+	FOnEnhancedComponentAvailable::FDelegate Delegate,
+	const float Timeout)
+{
+	UActorComponent* Component{Reference.GetComponent(&InstancedObject)};
+	if (Component != nullptr && Component->IsRegistered())
+	{
+		Delegate.ExecuteIfBound(Component);
+		return {};
+	}
+
+	const AActor* Actor{FindActor(InstancedObject)};
+	if (Actor == nullptr)
+	{
+		Delegate.ExecuteIfBound(nullptr);
+		return {};
+	}
+
+	FWaiter& Waiter{Waiters.FindOrAdd({&Reference, &InstancedObject})};
+	const bool bNew{Waiter.Delegates.IsEmpty()};
+	Waiter.Reference = &Reference;
+	Waiter.InstancedObject = &InstancedObject;
+	Waiter.Actor = Actor;
+
+	FName ChildActorComponent{};
+	FName ChildComponent{};
+	Waiter.bChildActorPath = UEnhancedComponentReference::SplitChildActorPath(
+		Reference.ComponentName,
+		ChildActorComponent,
+		ChildComponent);
+
+	// The component can already be there without being registered, in which case no new component is coming
+	Waiter.bUnregistered = Component != nullptr;
+
+	const FDelegateHandle Handle{FDelegateHandle::GenerateNewHandle};
+	Waiter.Delegates.Push({Handle, MoveTemp(Delegate), Timeout > 0.0f ? FPlatformTime::Seconds() + Timeout : 0.0});
+
+	if (bNew)
+	{
+		UpdateWatchedActors();
+	}
+
+	return Handle;
+}
+
+void UEnhancedComponentReferenceSubsystem::RemoveOnComponentAvailable(
+	const UEnhancedComponentReference& Reference,
+	const UObject& InstancedObject,
+	const FDelegateHandle Handle)
+{
+	const FWaiterKey Key{&Reference, &InstancedObject};
+	if (FWaiter* Waiter{Waiters.Find(Key)}; Waiter != nullptr)
+	{
+		Waiter->Delegates.RemoveAll([Handle](const FWaitingDelegate& Waiting)
+		{
+			return Waiting.Handle == Handle;
+		});
+		if (Waiter->Delegates.IsEmpty())
+		{
+			Waiters.Remove(Key);
+			UpdateWatchedActors();
+		}
+	}
+}
+
+UE::Tasks::TTask<TWeakObjectPtr<UActorComponent>> UEnhancedComponentReferenceSubsystem::WaitForComponent(
+	const UEnhancedComponentReference& Reference,
+	const UObject& InstancedObject,
+	const float Timeout)
+{
+	struct FState
+	{
+		UE::Tasks::FTaskEvent Event{UE_SOURCE_LOCATION};
+		TWeakObjectPtr<UActorComponent> Component;
+	};
+
+	const TSharedRef<FState> State{MakeShared<FState>()};
+	AddOnComponentAvailable(
+		Reference,
+		InstancedObject,
+		FOnEnhancedComponentAvailable::FDelegate::CreateLambda([State](UActorComponent* Component)
+		{
+			State->Component = Component;
+			State->Event.Trigger();
+		}),
+		Timeout);
+
+	return UE::Tasks::Launch(
+		UE_SOURCE_LOCATION,
+		[State] { return State->Component; },
+		UE::Tasks::Prerequisites(State->Event));
+}
+
+FEnhancedComponentAwaiter UEnhancedComponentReferenceSubsystem::AwaitComponent(
+	const UEnhancedComponentReference& Reference,
+	const UObject& InstancedObject,
+	const float Timeout)
+{
+	return {WaitForComponent(Reference, InstancedObject, Timeout)};
+}
+
+FDelegateHandle UEnhancedComponentReferenceSubsystem::AddArchetypeInterest(
+	const UEnhancedComponentReference& Reference,
+	FOnEnhancedComponentAvailable::FDelegate Delegate)
+{
+	if (!Reference.bUseOtherAsset || Reference.ProvidedArchetype.IsNull())
+	{
+		UE_LOG(
+			LogEnhancedComponentReference,
+			Warning,
+			TEXT("%s doesn't point into another actor, it needs bUseOtherAsset and a ProvidedArchetype"),
+			*Reference.GetPathName());
+		return {};
+	}
+
+	FArchetypeInterest& Interest{ArchetypeInterests.FindOrAdd(&Reference)};
+	const bool bNew{!Interest.Reference.IsValid()};
+	Interest.Reference = &Reference;
+	Interest.Archetype = Reference.ProvidedArchetype.ToSoftObjectPath().GetAssetPath();
+
+	if (AActor* Target{Interest.Target.Get()}; Target != nullptr)
+	{
+		Delegate.ExecuteIfBound(Interest.Component.Get());
+	}
+	else if (UClass* Archetype{Reference.ProvidedArchetype.Get()}; bNew && Archetype != nullptr)
+	{
+		// Only the actors that are already streamed in need to be looked at, the rest show up with their cells
+		for (const TWeakObjectPtr<AActor>& Actor : GetActors(*Archetype))
+		{
+			if (Actor.IsValid() && TryResolveInterest(Interest, *Actor))
+			{
+				Delegate.ExecuteIfBound(Interest.Component.Get());
+				break;
+			}
+		}
+	}
+
+	return Interest.Delegate.Add(MoveTemp(Delegate));
+}
+
+void UEnhancedComponentReferenceSubsystem::RemoveArchetypeInterest(
+	const UEnhancedComponentReference& Reference,
+	const FDelegateHandle Handle)
+{
+	if (FArchetypeInterest* Interest{ArchetypeInterests.Find(&Reference)}; Interest != nullptr)
+	{
+		Interest->Delegate.Remove(Handle);
+		if (!Interest->Delegate.IsBound())
+		{
+			ArchetypeInterests.Remove(&Reference);
+		}
+	}
+}
+
+UActorComponent* UEnhancedComponentReferenceSubsystem::GetArchetypeComponent(
+	const UEnhancedComponentReference& Reference) const
+{
+	const FArchetypeInterest* Interest{ArchetypeInterests.Find(&Reference)};
+	return Interest != nullptr ? Interest->Component.Get() : nullptr;
+}
+
+bool UEnhancedComponentReferenceSubsystem::TryResolveInterest(FArchetypeInterest& Interest, AActor& Actor)
+{
+	const UEnhancedComponentReference* Reference{Interest.Reference.Get()};
+	if (Reference == nullptr)
+	{
+		return false;
+	}
+
+	UActorComponent* Component{Reference->GetComponent(&Actor)};
+	if (Component == nullptr)
+	{
+		return false;
+	}
+
+	Interest.Target = &Actor;
+	Interest.Component = Component;
+	return true;
+}
+
+AActor* UEnhancedComponentReferenceSubsystem::FindOnlyActor(UClass& Class)
+{
+	TSet<TWeakObjectPtr<AActor>>& Actors{GetActors(Class)};
+
+	// Anything that got garbage collected without a destroy or a level removal is dropped here
+	for (auto It{Actors.CreateIterator()}; It; ++It)
+	{
+		if (!It->IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	if (Actors.Num() != 1)
+	{
+		return nullptr;
+	}
+
+	return Actors.begin()->Get();
+}
+
+AActor* UEnhancedComponentReferenceSubsystem::FindNearestActor(UClass& Class, const FVector& Location)
+{
+	AActor* Output{nullptr};
+	double BestDistance{TNumericLimits<double>::Max()};
+
+	for (auto It{GetActors(Class).CreateIterator()}; It; ++It)
+	{
+		AActor* Actor{It->Get()};
+		if (Actor == nullptr)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		if (const double Distance{FVector::DistSquared(Actor->GetActorLocation(), Location)}; Distance < BestDistance)
+		{
+			BestDistance = Distance;
+			Output = Actor;
+		}
+	}
+
+	return Output;
+}
+
+UActorComponent* UEnhancedComponentReferenceSubsystem::FindArchetypeComponent(
+	const UEnhancedComponentReference& Reference,
+	const TOptional<FVector>& Location)
+{
+	if (!Reference.bUseOtherAsset)
+	{
+		UE_LOG(
+			LogEnhancedComponentReference,
+			Warning,
+			TEXT("%s doesn't point into another actor, it needs bUseOtherAsset and a ProvidedArchetype"),
+			*Reference.GetPathName());
+		return nullptr;
+	}
+
+	// No actor can be of a class that isn't loaded
+	UClass* Archetype{Reference.ProvidedArchetype.Get()};
+	if (Archetype == nullptr)
+	{
+		return nullptr;
+	}
+
+	const AActor* Actor{Location.IsSet() ? FindNearestActor(*Archetype, *Location) : FindOnlyActor(*Archetype)};
+	return Actor != nullptr ? Reference.GetComponent(Actor) : nullptr;
+}
+
+TSet<TWeakObjectPtr<AActor>>& UEnhancedComponentReferenceSubsystem::GetActors(UClass& Class)
+{
+	if (TSet<TWeakObjectPtr<AActor>>* Actors{ActorsByClass.Find(&Class)}; Actors != nullptr)
+	{
+		return *Actors;
+	}
+
+	// The world only gets gone through once per class, from then on the spawns and destroys keep it up to date
+	TSet<TWeakObjectPtr<AActor>>& Actors{ActorsByClass.Add(&Class)};
+	for (TActorIterator<AActor> It{GetWorld(), &Class}; It; ++It)
+	{
+		Actors.Add(*It);
+	}
+
+	return Actors;
+}
+
+void UEnhancedComponentReferenceSubsystem::IndexActor(AActor& Actor)
+{
+	if (ActorsByClass.IsEmpty())
+	{
+		return;
+	}
+
+	for (const UClass* Class{Actor.GetClass()}; Class != nullptr; Class = Class->GetSuperClass())
+	{
+		if (TSet<TWeakObjectPtr<AActor>>* Actors{ActorsByClass.Find(Class)}; Actors != nullptr)
+		{
+			Actors->Add(&Actor);
+		}
+	}
+}
+
+void UEnhancedComponentReferenceSubsystem::HandleActorSpawned(AActor* Actor)
+{
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	IndexActor(*Actor);
+
+	// The actor of an archetype can be spawned at runtime instead of coming with a cell
+	if (!ArchetypeInterests.IsEmpty())
+	{
+		ResolveInterests(MakeArrayView(&Actor, 1));
+	}
+}
+
+void UEnhancedComponentReferenceSubsystem::HandleActorDestroyed(AActor* Actor)
+{
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	for (const UClass* Class{Actor->GetClass()}; Class != nullptr; Class = Class->GetSuperClass())
+	{
+		if (TSet<TWeakObjectPtr<AActor>>* Actors{ActorsByClass.Find(Class)}; Actors != nullptr)
+		{
+			Actors->Remove(Actor);
+		}
+	}
+
+	// Copied out for the same reason as in ResolveInterests, the interests go back to pending until another actor of
+	// the archetype shows up
+	TArray<FOnEnhancedComponentAvailable> Cleared{};
+	for (TPair<TObjectKey<UEnhancedComponentReference>, FArchetypeInterest>& Entry : ArchetypeInterests)
+	{
+		FArchetypeInterest& Interest{Entry.Value};
+		if (Interest.Target.Get() == Actor)
+		{
+			Interest.Target.Reset();
+			Interest.Component.Reset();
+			Cleared.Push(Interest.Delegate);
+		}
+	}
+
+	for (const FOnEnhancedComponentAvailable& Delegate : Cleared)
+	{
+		Delegate.Broadcast(nullptr);
+	}
+}
+
+void UEnhancedComponentReferenceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	CreateListener = MakeShared<FCreateListener>();
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(
+		this,
+		&UEnhancedComponentReferenceSubsystem::HandleLevelAdded);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(
+		this,
+		&UEnhancedComponentReferenceSubsystem::HandleLevelRemoved);
+
+	UWorld& World{*GetWorld()};
+	ActorSpawnedHandle = World.AddOnActorSpawnedHandler(
+		FOnActorSpawned::FDelegate::CreateUObject(this, &UEnhancedComponentReferenceSubsystem::HandleActorSpawned));
+	ActorDestroyedHandle = World.AddOnActorDestroyedHandler(
+		FOnActorDestroyed::FDelegate::CreateUObject(this, &UEnhancedComponentReferenceSubsystem::HandleActorDestroyed));
+}
+
+bool UEnhancedComponentReferenceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnhancedComponentReferenceSubsystem::Deinitialize()
+{
+	// The tasks, the coroutines and the Blueprint nodes waiting would never finish otherwise
+	TArray<FOnEnhancedComponentAvailable::FDelegate> Pending{};
+	for (TPair<FWaiterKey, FWaiter>& Entry : Waiters)
+	{
+		for (FWaitingDelegate& Waiting : Entry.Value.Delegates)
+		{
+			Pending.Push(MoveTemp(Waiting.Delegate));
+		}
+	}
+	Waiters.Empty();
+	CreateListener.Reset();
+
+	for (const FOnEnhancedComponentAvailable::FDelegate& Delegate : Pending)
+	{
+		Delegate.ExecuteIfBound(nullptr);
+	}
+
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	GetWorld()->RemoveOnActorDestroyededHandler(ActorDestroyedHandle);
+
+	Super::Deinitialize();
+}
+
+void UEnhancedComponentReferenceSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TickWaiters();
+
+	if (!PrewarmClasses.IsEmpty() || !PrewarmActors.IsEmpty())
+	{
+		Prewarm(CVarPrewarmBudget.GetValueOnGameThread() / 1000.0);
+	}
+}
+
+void UEnhancedComponentReferenceSubsystem::TickWaiters()
+{
+	TSet<const UObjectBase*> ChangedActors{};
+	const bool bActorCreated{CreateListener->TakeChanges(ChangedActors)};
+	const double Now{FPlatformTime::Seconds()};
+
+	// The delegates get called once the waiters are out of the map, since they can start waiting on something else
+	TArray<TPair<FOnEnhancedComponentAvailable::FDelegate, UActorComponent*>> Ready{};
+	const auto Complete{[&Ready](FWaiter& Waiter, UActorComponent* Component)
+	{
+		for (FWaitingDelegate& Waiting : Waiter.Delegates)
+		{
+			Ready.Emplace(MoveTemp(Waiting.Delegate), Component);
+		}
+	}};
+
+	const int32 WaiterCount{Waiters.Num()};
+	for (auto It{Waiters.CreateIterator()}; It; ++It)
+	{
+		FWaiter& Waiter{It.Value()};
+
+		const UEnhancedComponentReference* Reference{Waiter.Reference.Get()};
+		const UObject* InstancedObject{Waiter.InstancedObject.Get()};
+		const AActor* Actor{Waiter.Actor.Get()};
+		if (Reference == nullptr || InstancedObject == nullptr || Actor == nullptr)
+		{
+			Complete(Waiter, nullptr);
+			It.RemoveCurrent();
+			continue;
+		}
+
+		// Only the owners that got new components are looked at again, plus the components waiting to be registered
+		// (which are already cached, so getting them again is cheap)
+		if (Waiter.bUnregistered || ChangedActors.Contains(Actor) || (bActorCreated && Waiter.bChildActorPath))
+		{
+			UActorComponent* Component{Reference->GetComponent(InstancedObject)};
+			if (Component != nullptr && Component->IsRegistered())
+			{
+				Complete(Waiter, Component);
+				It.RemoveCurrent();
+				continue;
+			}
+
+			Waiter.bUnregistered = Component != nullptr;
+		}
+
+		for (int32 Index{Waiter.Delegates.Num() - 1}; Index >= 0; --Index)
+		{
+			const double Deadline{Waiter.Delegates[Index].Deadline};
+			if (Deadline > 0.0 && Now > Deadline)
+			{
+				UE_LOG(
+					LogEnhancedComponentReference,
+					Warning,
+					TEXT("Gave up waiting for %s on %s"),
+					*Reference->GetPathName(),
+					*InstancedObject->GetPathName());
+				Ready.Emplace(MoveTemp(Waiter.Delegates[Index].Delegate), nullptr);
+				Waiter.Delegates.RemoveAt(Index);
+			}
+		}
+
+		if (Waiter.Delegates.IsEmpty())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	if (Waiters.Num() != WaiterCount)
+	{
+		UpdateWatchedActors();
+	}
+
+	for (const TPair<FOnEnhancedComponentAvailable::FDelegate, UActorComponent*>& Entry : Ready)
+	{
+		Entry.Key.ExecuteIfBound(Entry.Value);
+	}
+}
+
+void UEnhancedComponentReferenceSubsystem::UpdateWatchedActors()
+{
+	TSet<const UObjectBase*> Actors{};
+	bool bAnyActor{false};
+	for (const TPair<FWaiterKey, FWaiter>& Entry : Waiters)
+	{
+		if (const AActor* Actor{Entry.Value.Actor.Get()}; Actor != nullptr)
+		{
+			Actors.Add(Actor);
+			bAnyActor |= Entry.Value.bChildActorPath;
+		}
+	}
+
+	// Nothing is listened for anymore once the world goes away
+	if (CreateListener.IsValid())
+	{
+		CreateListener->Watch(MoveTemp(Actors), bAnyActor);
+	}
+}
+
+void UEnhancedComponentReferenceSubsystem::HandleLevelAdded(ULevel* Level, UWorld* World)
+{
+	if (Level == nullptr || World != GetWorld())
+	{
+		return;
+	}
+
+	// In World Partition every cell is a level of its own
+	ResolveInterests(*Level);
+
+	TSet<UClass*> Classes{};
+	for (AActor* Actor : Level->Actors)
+	{
+		if (!IsValid(Actor))
+		{
+			continue;
+		}
+
+		PrewarmActors.Push(Actor);
+		IndexActor(*Actor);
+
+		bool bAlreadyQueued{false};
+		Classes.Add(Actor->GetClass(), &bAlreadyQueued);
+		if (!bAlreadyQueued)
+		{
+			PrewarmClasses.Push(Actor->GetClass());
+		}
+	}
+}
+
+void UEnhancedComponentReferenceSubsystem::HandleLevelRemoved(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	// The actors of the level aren't destroyed when it streams out, so they have to be taken out of the index here
+	for (TPair<TObjectKey<UClass>, TSet<TWeakObjectPtr<AActor>>>& Entry : ActorsByClass)
+	{
+		for (auto It{Entry.Value.CreateIterator()}; It; ++It)
+		{
+			const AActor* Actor{It->Get()};
+			if (Actor == nullptr || Level == nullptr || Actor->GetLevel() == Level)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	// Copied out for the same reason as in ResolveInterests
+	TArray<FOnEnhancedComponentAvailable> Cleared{};
+	for (TPair<TObjectKey<UEnhancedComponentReference>, FArchetypeInterest>& Entry : ArchetypeInterests)
+	{
+		FArchetypeInterest& Interest{Entry.Value};
+
+		// A null level means that every level got removed
+		const AActor* Target{Interest.Target.Get()};
+		if (Target != nullptr && Level != nullptr && Target->GetLevel() != Level)
+		{
+			continue;
+		}
+
+		const bool bWasResolved{Interest.Component.IsValid()};
+		Interest.Target.Reset();
+		Interest.Component.Reset();
+
+		if (bWasResolved)
+		{
+			Cleared.Push(Interest.Delegate);
+		}
+	}
+
+	for (const FOnEnhancedComponentAvailable& Delegate : Cleared)
+	{
+		Delegate.Broadcast(nullptr);
+	}
+}
+
+void UEnhancedComponentReferenceSubsystem::ResolveInterests(const ULevel& Level)
+{
+	TArray<AActor*> Actors{};
+	Actors.Reserve(Level.Actors.Num());
+	for (AActor* Actor : Level.Actors)
+	{
+		Actors.Push(Actor);
+	}
+
+	ResolveInterests(Actors);
+}
+
+void UEnhancedComponentReferenceSubsystem::ResolveInterests(const TConstArrayView<AActor*> Actors)
+{
+	TSet<FTopLevelAssetPath> Pending{};
+	for (const TPair<TObjectKey<UEnhancedComponentReference>, FArchetypeInterest>& Entry : ArchetypeInterests)
+	{
+		if (!Entry.Value.Target.IsValid())
+		{
+			Pending.Add(Entry.Value.Archetype);
+		}
+	}
+
+	if (Pending.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FArchetypeInterest*> Resolved{};
+	for (AActor* Actor : Actors)
+	{
+		if (!IsValid(Actor))
+		{
+			continue;
+		}
+
+		// The archetype can be any class in the hierarchy of the actor
+		for (const UClass* Class{Actor->GetClass()}; Class != nullptr; Class = Class->GetSuperClass())
+		{
+			if (!Pending.Contains(Class->GetClassPathName()))
+			{
+				continue;
+			}
+
+			for (TPair<TObjectKey<UEnhancedComponentReference>, FArchetypeInterest>& Entry : ArchetypeInterests)
+			{
+				FArchetypeInterest& Interest{Entry.Value};
+				if (!Interest.Target.IsValid() && Interest.Archetype == Class->GetClassPathName() &&
+					TryResolveInterest(Interest, *Actor))
+				{
+					Resolved.Push(&Interest);
+				}
+			}
+		}
+	}
+
+	// The delegates could add interests of their own, which would move the entries of the map
+	TArray<TPair<FOnEnhancedComponentAvailable, UActorComponent*>> Ready{};
+	for (const FArchetypeInterest* Interest : Resolved)
+	{
+		Ready.Emplace(Interest->Delegate, Interest->Component.Get());
+	}
+
+	for (const TPair<FOnEnhancedComponentAvailable, UActorComponent*>& Entry : Ready)
+	{
+		Entry.Key.Broadcast(Entry.Value);
+	}
+}
+
+void UEnhancedComponentReferenceSubsystem::Prewarm(const double Budget)
+{
+	const double EndTime{FPlatformTime::Seconds() + Budget};
+
+	// Building the indices is the expensive part, and it only happens once per class
+	while (!PrewarmClasses.IsEmpty() && FPlatformTime::Seconds() < EndTime)
+	{
+		if (const UClass* Class{PrewarmClasses.Pop(EAllowShrinking::No).Get()}; Class != nullptr)
+		{
+			(void)FEnhancedComponentIndex::Get(*Class);
+		}
+	}
+
+	TArray<UObject*> Subobjects{};
+	while (!PrewarmActors.IsEmpty() && FPlatformTime::Seconds() < EndTime)
+	{
+		const AActor* Actor{PrewarmActors.Pop(EAllowShrinking::No).Get()};
+		if (Actor == nullptr)
+		{
+			continue;
+		}
+
+		// The references are subobjects of the actor or of its components, resolving them fills their caches
+		Subobjects.Reset();
+		GetObjectsWithOuter(Actor, Subobjects, true);
+		for (const UObject* Subobject : Subobjects)
+		{
+			const UEnhancedComponentReference* Reference{Cast<UEnhancedComponentReference>(Subobject)};
+			if (Reference == nullptr || Reference->GetOuter() == nullptr)
+			{
+				continue;
+			}
+
+			// The references into other actors would be resolved against this one (and fail), and the ones that were
+			// never set up (or whose soft type isn't loaded yet) would only log warnings
+			if (Reference->bUseOtherAsset || Reference->ComponentName.IsNone() || Reference->GetType() == nullptr)
+			{
+				continue;
+			}
+
+			(void)Reference->GetComponent(Reference->GetOuter());
+		}
+	}
+
+	// Streaming a big level in can leave a lot of slack behind
+	if (PrewarmActors.IsEmpty())
+	{
+		PrewarmActors.Empty();
+	}
+}
+
+bool UEnhancedComponentReferenceSubsystem::IsTickable() const
+{
+	return !Waiters.IsEmpty() || !PrewarmClasses.IsEmpty() || !PrewarmActors.IsEmpty();
+}
+
+TStatId UEnhancedComponentReferenceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnhancedComponentReferenceSubsystem, STATGROUP_Tickables);
+}
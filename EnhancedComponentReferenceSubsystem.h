@@ -0,0 +1,288 @@
+﻿/**
+ * @file EnhancedComponentReferenceSubsystem.h
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief World subsystem notifying when the component of a reference shows up on its owner, for the components that
+ * get added after BeginPlay (deferred spawns, construction scripts or gameplay). It also resolves the references of
+ * the streamed in levels ahead of time, a slice every frame, and keeps the references into other actors resolved
+ * while the cells of those actors are streamed in. The live actors are indexed by class for finding the actor of an
+ * archetype without going through the whole world.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#pragma once
+
+#include <coroutine>
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "EnhancedComponentReferenceSubsystem.generated.h"
+
+class UEnhancedComponentReference;
+
+/**
+ * Called with the component once it is registered on the owner, null if the owner or the reference got destroyed
+ * first, if the wait timed out or if the world went away
+ */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnEnhancedComponentAvailable, UActorComponent*);
+
+/**
+ * @brief Awaiter for the coroutines waiting on a component, the coroutine resumes on the game thread.
+ *
+ * UActorComponent* Component{co_await Subsystem->AwaitComponent(*MyShapeRef, *this)};
+ */
+struct FEnhancedComponentAwaiter
+{
+	UE::Tasks::TTask<TWeakObjectPtr<UActorComponent>> Task;
+
+	[[nodiscard]] bool await_ready() const
+	{
+		return Task.IsCompleted();
+	}
+
+	void await_suspend(std::coroutine_handle<> Continuation) const
+	{
+		UE::Tasks::Launch(
+			UE_SOURCE_LOCATION,
+			[Continuation] { Continuation.resume(); },
+			UE::Tasks::Prerequisites(Task),
+			UE::Tasks::ETaskPriority::Normal,
+			UE::Tasks::EExtendedTaskPriority::GameThreadNormalPri);
+	}
+
+	[[nodiscard]] UActorComponent* await_resume() const
+	{
+		return Task.GetResult().Get();
+	}
+};
+
+/**
+ * @brief Keeps the references waiting for their components and checks them after the actors tick, and prewarms the
+ * references of the levels added to the world.
+ */
+UCLASS()
+class IDOLONDUTY_API UEnhancedComponentReferenceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * @brief Calls the delegate once the component of the reference is on the owner.
+	 * @param Reference The reference to resolve
+	 * @param InstancedObject The owner that we should be fetching from
+	 * @param Delegate Called with the component, right away if it is already there
+	 * @param Timeout Seconds after which the delegate gets called with null, 0 to wait for as long as the owner lives
+	 * @return Handle for removing the delegate, invalid if it was already called
+	 */
+	FDelegateHandle AddOnComponentAvailable(
+		const UEnhancedComponentReference& Reference,
+		const UObject& InstancedObject,
+		FOnEnhancedComponentAvailable::FDelegate Delegate,
+		float Timeout = 0.0f);
+
+	void RemoveOnComponentAvailable(
+		const UEnhancedComponentReference& Reference,
+		const UObject& InstancedObject,
+		FDelegateHandle Handle);
+
+	/**
+	 * @brief Gets a task completing once the component of the reference is on the owner. The component can only be
+	 * used from the game thread.
+	 */
+	[[nodiscard]] UE::Tasks::TTask<TWeakObjectPtr<UActorComponent>> WaitForComponent(
+		const UEnhancedComponentReference& Reference,
+		const UObject& InstancedObject,
+		float Timeout = 0.0f);
+
+	/**
+	 * @brief Same as WaitForComponent, for awaiting it from a coroutine.
+	 */
+	[[nodiscard]] FEnhancedComponentAwaiter AwaitComponent(
+		const UEnhancedComponentReference& Reference,
+		const UObject& InstancedObject,
+		float Timeout = 0.0f);
+
+	/**
+	 * @brief Keeps a reference using another asset resolved against the actor of its ProvidedArchetype. While that
+	 * actor isn't streamed in the interest stays pending, and it gets resolved when the cell of the actor loads instead
+	 * of scanning again and again.
+	 * @param Reference The reference to resolve, it needs bUseOtherAsset and a ProvidedArchetype
+	 * @param Delegate Called with the component whenever its actor streams in, and with null when it streams out
+	 * @return Handle for removing the delegate, invalid if the reference doesn't point into another actor
+	 */
+	FDelegateHandle AddArchetypeInterest(
+		const UEnhancedComponentReference& Reference,
+		FOnEnhancedComponentAvailable::FDelegate Delegate);
+
+	void RemoveArchetypeInterest(const UEnhancedComponentReference& Reference, FDelegateHandle Handle);
+
+	/**
+	 * @brief Gets the component of a reference with an interest, without searching for it.
+	 * @return The component, null while its actor isn't streamed in
+	 */
+	[[nodiscard]] UActorComponent* GetArchetypeComponent(const UEnhancedComponentReference& Reference) const;
+
+	/**
+	 * @brief Gets the only live actor of a class (or of a child of it).
+	 * @return The actor, null if there are none or more than one
+	 */
+	[[nodiscard]] AActor* FindOnlyActor(UClass& Class);
+
+	/**
+	 * @brief Gets the live actor of a class (or of a child of it) closest to a location.
+	 */
+	[[nodiscard]] AActor* FindNearestActor(UClass& Class, const FVector& Location);
+
+	/**
+	 * @brief Gets the component of a reference using another asset on the only actor of its ProvidedArchetype, or on
+	 * the one closest to a location if there can be more than one.
+	 * @param Reference The reference to resolve, it needs bUseOtherAsset and a ProvidedArchetype
+	 * @param Location Where to look from, without it the archetype has to have a single instance
+	 * @return The component, null if there is no such actor or if it doesn't have it
+	 */
+	[[nodiscard]] UActorComponent* FindArchetypeComponent(
+		const UEnhancedComponentReference& Reference,
+		const TOptional<FVector>& Location = {});
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/**
+	 * @brief Only game and PIE worlds, the editor worlds never tick so the streamed in actors would pile up.
+	 */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override;
+
+	virtual TStatId GetStatId() const override;
+
+private:
+	/**
+	 * @brief Tells which of the waited actors got new components, from whichever thread creates them.
+	 */
+	class FCreateListener;
+
+	/**
+	 * @brief A delegate waiting on a reference, with its own timeout.
+	 */
+	struct FWaitingDelegate
+	{
+		FDelegateHandle Handle;
+
+		FOnEnhancedComponentAvailable::FDelegate Delegate;
+
+		/** When to give up and call the delegate with null, 0 to never give up */
+		double Deadline{0.0};
+	};
+
+	/**
+	 * @brief The delegates waiting on a reference for an owner.
+	 */
+	struct FWaiter
+	{
+		TWeakObjectPtr<const UEnhancedComponentReference> Reference;
+		TWeakObjectPtr<const UObject> InstancedObject;
+		TWeakObjectPtr<const AActor> Actor;
+
+		/** Whether the reference points into a child actor, which can be spawned again with the components in it */
+		bool bChildActorPath{false};
+
+		/** Whether the component was found but isn't registered yet, like the ones of deferred spawns */
+		bool bUnregistered{false};
+
+		TArray<FWaitingDelegate> Delegates;
+	};
+
+	using FWaiterKey = TPair<TObjectKey<UEnhancedComponentReference>, TObjectKey<UObject>>;
+
+	/**
+	 * @brief A reference into the actor of an archetype, which might be in a cell that isn't loaded.
+	 */
+	struct FArchetypeInterest
+	{
+		TWeakObjectPtr<const UEnhancedComponentReference> Reference;
+
+		/** Path of the class of the actor, the class itself might not be loaded yet */
+		FTopLevelAssetPath Archetype;
+
+		/** Actor the component was resolved on, null while the interest is pending */
+		TWeakObjectPtr<AActor> Target;
+
+		TWeakObjectPtr<UActorComponent> Component;
+
+		FOnEnhancedComponentAvailable Delegate;
+	};
+
+	/**
+	 * @brief Tries to resolve the interest against the actor, does nothing if it isn't of the archetype.
+	 * @return Whether the interest got resolved
+	 */
+	static bool TryResolveInterest(FArchetypeInterest& Interest, AActor& Actor);
+
+	void TickWaiters();
+
+	/**
+	 * @brief Gives the actors of the waiters to the listener, which only listens while there are waiters.
+	 */
+	void UpdateWatchedActors();
+
+	/**
+	 * @brief Gets the live actors of a class and its children, the classes only get indexed once they are asked for.
+	 */
+	TSet<TWeakObjectPtr<AActor>>& GetActors(UClass& Class);
+
+	/**
+	 * @brief Adds the actor to the indexed classes of its hierarchy.
+	 */
+	void IndexActor(AActor& Actor);
+
+	void HandleActorSpawned(AActor* Actor);
+
+	void HandleActorDestroyed(AActor* Actor);
+
+	void HandleLevelAdded(ULevel* Level, UWorld* World);
+
+	void HandleLevelRemoved(ULevel* Level, UWorld* World);
+
+	/**
+	 * @brief Resolves the pending interests whose archetype is the one of an actor of the level.
+	 */
+	void ResolveInterests(const ULevel& Level);
+
+	/**
+	 * @brief Resolves the pending interests whose archetype is the one of any of the actors.
+	 */
+	void ResolveInterests(TConstArrayView<AActor*> Actors);
+
+	/**
+	 * @brief Resolves the queued references until the time runs out, the rest are left for the next frame.
+	 * @param Budget Time in seconds that can be spent
+	 */
+	void Prewarm(double Budget);
+
+	TMap<FWaiterKey, FWaiter> Waiters;
+
+	TSharedPtr<FCreateListener> CreateListener;
+
+	/** Classes of the streamed in actors, their indices get built before resolving anything */
+	TArray<TWeakObjectPtr<UClass>> PrewarmClasses;
+
+	/** Streamed in actors whose references still have to be resolved */
+	TArray<TWeakObjectPtr<AActor>> PrewarmActors;
+
+	TMap<TObjectKey<UEnhancedComponentReference>, FArchetypeInterest> ArchetypeInterests;
+
+	/** Live actors of the classes that were looked for, including the actors of their children */
+	TMap<TObjectKey<UClass>, TSet<TWeakObjectPtr<AActor>>> ActorsByClass;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle ActorDestroyedHandle;
+
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+};
@@ -0,0 +1,261 @@
+﻿/**
+ * @file EnhancedComponentResolutionPlan.cpp
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Implementation of the compiled lookups used by the enhanced component references.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#include "Utilities/Property/EnhancedComponentResolutionPlan.h"
+
+#include "Utilities/Property/EnhancedComponentManifest.h"
+#include "Utilities/Property/EnhancedComponentReference.h"
+#include "Components/ActorComponent.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	struct FPlanKey
+	{
+		TObjectKey<UClass> ActorClass;
+		FName ComponentName;
+		TObjectKey<UClass> Type;
+
+		bool operator==(const FPlanKey& Other) const
+		{
+			return ActorClass == Other.ActorClass && ComponentName == Other.ComponentName && Type == Other.Type;
+		}
+
+		friend uint32 GetTypeHash(const FPlanKey& Key)
+		{
+			return HashCombineFast(
+				HashCombineFast(GetTypeHash(Key.ActorClass), GetTypeHash(Key.ComponentName)),
+				GetTypeHash(Key.Type));
+		}
+	};
+
+	TMap<FPlanKey, FEnhancedComponentResolutionPlan> Plans{};
+
+	/** Generation of the class indices that the plans were compiled against */
+	uint32 PlansGeneration{0};
+
+	FAutoConsoleCommand DumpPlansCommand{
+		TEXT("EnhancedComponentReference.DumpPlans"),
+		TEXT("Logs the resolution plan of every (class, reference) pair, with the slowest ones first"),
+		FConsoleCommandDelegate::CreateLambda([]
+		{
+			for (const FEnhancedComponentPlanStatistics& Entry : FEnhancedComponentPlanCache::GetStatistics())
+			{
+				UE_LOG(
+					LogEnhancedComponentReference,
+					Display,
+					TEXT("%s.%s (%s): %s, %llu executions, %llu fallbacks"),
+					*Entry.ActorClass,
+					*Entry.ComponentName.ToString(),
+					*Entry.Type,
+					FEnhancedComponentPlanCache::LexToString(Entry.Step),
+					Entry.Executions,
+					Entry.Fallbacks);
+			}
+		})
+	};
+
+	FAutoConsoleCommand ResetPlansCommand{
+		TEXT("EnhancedComponentReference.ResetPlanStatistics"),
+		TEXT("Resets the counters of the resolution plans"),
+		FConsoleCommandDelegate::CreateStatic(&FEnhancedComponentPlanCache::ResetStatistics)
+	};
+}
+
+UActorComponent* FEnhancedComponentPlanCache::Resolve(
+	const AActor& Actor,
+	const FName ComponentName,
+	const TSubclassOf<UActorComponent> Type)
+{
+	check(IsInGameThread());
+
+	// Plans point to slots of the indices, so they can't outlive them
+	if (PlansGeneration != FEnhancedComponentIndex::GetGeneration())
+	{
+		Plans.Reset();
+		PlansGeneration = FEnhancedComponentIndex::GetGeneration();
+	}
+
+	const FPlanKey Key{Actor.GetClass(), ComponentName, Type.Get()};
+	FEnhancedComponentResolutionPlan* Plan{Plans.Find(Key)};
+	if (Plan == nullptr)
+	{
+		// Cooked builds get the plans compiled when cooking, without having to build the index of the class
+		FEnhancedComponentResolutionPlan NewPlan{};
+		// A mismatch can't be verified like the other steps can, and a manifest written before the type got fixed
+		// would null the reference for good, so those get compiled against the loaded class instead
+		if (!FEnhancedComponentManifest::Get().FindPlan(*Actor.GetClass(), ComponentName, Type, NewPlan) ||
+			NewPlan.Step == EEnhancedComponentPlanStep::TypeMismatch)
+		{
+			NewPlan = Compile(*Actor.GetClass(), ComponentName, Type);
+		}
+
+		Plan = &Plans.Add(Key, MoveTemp(NewPlan));
+	}
+
+	++Plan->Executions;
+
+	switch (Plan->Step)
+	{
+	case EEnhancedComponentPlanStep::TypeMismatch:
+		return nullptr;
+
+	case EEnhancedComponentPlanStep::Scan:
+		return Scan(Actor, ComponentName, Type);
+
+	default:
+		break;
+	}
+
+	if (UActorComponent* Component{FEnhancedComponentIndex::Resolve(Plan->Slot, Actor)}; Component != nullptr)
+	{
+		return Component->IsA(Type) ? Component : nullptr;
+	}
+
+	// The instance doesn't match its class anymore (e.g. the component was destroyed and created again)
+	++Plan->Fallbacks;
+	return Scan(Actor, ComponentName, Type);
+}
+
+FEnhancedComponentResolutionPlan FEnhancedComponentPlanCache::Compile(
+	const UClass& ActorClass,
+	const FName ComponentName,
+	const TSubclassOf<UActorComponent> Type)
+{
+	FEnhancedComponentResolutionPlan Output{};
+
+	const TSharedRef<const FEnhancedComponentIndex> Index{FEnhancedComponentIndex::Get(ActorClass)};
+	const FEnhancedComponentSlot* Slot{Index->Find(ComponentName)};
+	if (Slot == nullptr)
+	{
+		Output.Step = EEnhancedComponentPlanStep::Scan;
+		return Output;
+	}
+
+	Output.Slot = *Slot;
+
+	if (const UClass* ComponentClass{Slot->ComponentClass.Get()};
+		ComponentClass != nullptr && !ComponentClass->IsChildOf(Type))
+	{
+		Output.Step = EEnhancedComponentPlanStep::TypeMismatch;
+	}
+	else if (Slot->Property != nullptr)
+	{
+		Output.Step = EEnhancedComponentPlanStep::ReadProperty;
+	}
+	else if (Slot->Kind == EEnhancedComponentSlotKind::Blueprint)
+	{
+		Output.Step = EEnhancedComponentPlanStep::BlueprintIndex;
+	}
+	else
+	{
+		Output.Step = EEnhancedComponentPlanStep::FindSubobject;
+	}
+
+	return Output;
+}
+
+UActorComponent* FEnhancedComponentPlanCache::Scan(
+	const AActor& Actor,
+	const FName ComponentName,
+	const TSubclassOf<UActorComponent> Type)
+{
+	// Checking the C++ components
+	TArray<UActorComponent*> Components{};
+	Actor.GetComponents(Type, Components);
+
+	for (UActorComponent* CurrentComponent : Components)
+	{
+		if (CurrentComponent->GetFName() == ComponentName)
+		{
+			return CurrentComponent;
+		}
+	}
+
+	// Checking the BP Components
+	for (UActorComponent* CurrentComponent : Actor.BlueprintCreatedComponents)
+	{
+		if (CurrentComponent == nullptr || CurrentComponent->GetFName() != ComponentName)
+		{
+			continue;
+		}
+
+		if (!CurrentComponent->GetClass()->IsChildOf(Type))
+		{
+			continue;
+		}
+
+		return CurrentComponent;
+	}
+
+	return nullptr;
+}
+
+TArray<FEnhancedComponentPlanStatistics> FEnhancedComponentPlanCache::GetStatistics()
+{
+	TArray<FEnhancedComponentPlanStatistics> Output{};
+	Output.Reserve(Plans.Num());
+
+	for (const TPair<FPlanKey, FEnhancedComponentResolutionPlan>& Entry : Plans)
+	{
+		const UClass* ActorClass{Entry.Key.ActorClass.ResolveObjectPtr()};
+		const UClass* Type{Entry.Key.Type.ResolveObjectPtr()};
+
+		FEnhancedComponentPlanStatistics& Statistics{Output.AddDefaulted_GetRef()};
+		Statistics.ActorClass = ActorClass != nullptr ? ActorClass->GetName() : TEXT("None");
+		Statistics.ComponentName = Entry.Key.ComponentName;
+		Statistics.Type = Type != nullptr ? Type->GetName() : TEXT("None");
+		Statistics.Step = Entry.Value.Step;
+		Statistics.Executions = Entry.Value.Executions;
+		Statistics.Fallbacks = Entry.Value.Fallbacks;
+	}
+
+	// Every execution of a scanning plan and every fallback paid for a scan
+	const auto ScanCount{
+		[](const FEnhancedComponentPlanStatistics& Statistics)
+		{
+			return Statistics.Step == EEnhancedComponentPlanStep::Scan ? Statistics.Executions : Statistics.Fallbacks;
+		}
+	};
+	Output.Sort([&ScanCount](const FEnhancedComponentPlanStatistics& Lhs, const FEnhancedComponentPlanStatistics& Rhs)
+	{
+		return ScanCount(Lhs) > ScanCount(Rhs);
+	});
+
+	return Output;
+}
+
+void FEnhancedComponentPlanCache::ResetStatistics()
+{
+	for (TPair<FPlanKey, FEnhancedComponentResolutionPlan>& Entry : Plans)
+	{
+		Entry.Value.Executions = 0;
+		Entry.Value.Fallbacks = 0;
+	}
+}
+
+const TCHAR* FEnhancedComponentPlanCache::LexToString(const EEnhancedComponentPlanStep Step)
+{
+	switch (Step)
+	{
+	case EEnhancedComponentPlanStep::ReadProperty:
+		return TEXT("ReadProperty");
+	case EEnhancedComponentPlanStep::BlueprintIndex:
+		return TEXT("BlueprintIndex");
+	case EEnhancedComponentPlanStep::FindSubobject:
+		return TEXT("FindSubobject");
+	case EEnhancedComponentPlanStep::TypeMismatch:
+		return TEXT("TypeMismatch");
+	case EEnhancedComponentPlanStep::Scan:
+		return TEXT("Scan");
+	}
+
+	return TEXT("Unknown");
+}
@@ -0,0 +1,113 @@
+﻿/**
+ * @file EnhancedComponentResolutionPlan.h
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Precompiled lookups for the enhanced component references. The path to a component only depends on the
+ * class of the actor, the name and the type, so it is decided once and then replayed on every call.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utilities/Property/EnhancedComponentIndex.h"
+
+class AActor;
+class UActorComponent;
+
+/**
+ * @brief The step that a plan runs to get to the component.
+ */
+enum class EEnhancedComponentPlanStep : uint8
+{
+	/** Read the component from a property of the actor */
+	ReadProperty,
+
+	/** Read an entry of BlueprintCreatedComponents and verify its name */
+	BlueprintIndex,
+
+	/** Find the default subobject by name in the actor */
+	FindSubobject,
+
+	/** The component is part of the class, but it is not of the requested type */
+	TypeMismatch,
+
+	/** The component is not part of the class (created at runtime), so the components have to be scanned */
+	Scan,
+};
+
+/**
+ * @brief Compiled lookup for a (class, reference) pair.
+ */
+struct FEnhancedComponentResolutionPlan
+{
+	EEnhancedComponentPlanStep Step{EEnhancedComponentPlanStep::Scan};
+
+	/** The slot to read, not used by the scanning and mismatch steps */
+	FEnhancedComponentSlot Slot;
+
+	/** Amount of times the plan was run */
+	uint64 Executions{0};
+
+	/** Amount of times the step failed and the components had to be scanned anyway */
+	uint64 Fallbacks{0};
+};
+
+/**
+ * @brief Snapshot of a plan for debugging which references end up in the slow path.
+ */
+struct FEnhancedComponentPlanStatistics
+{
+	FString ActorClass;
+	FName ComponentName;
+	FString Type;
+	EEnhancedComponentPlanStep Step{EEnhancedComponentPlanStep::Scan};
+	uint64 Executions{0};
+	uint64 Fallbacks{0};
+};
+
+/**
+ * @brief Cache of the plans for every (class, reference) pair that has been resolved. The plans get dropped whenever
+ * any class index does, and like the indices they can only be used from the game thread.
+ */
+class IDOLONDUTY_API FEnhancedComponentPlanCache
+{
+public:
+	/**
+	 * @brief Runs the plan for the pair, compiling it the first time that the pair is seen.
+	 * @param Actor The actor to look into
+	 * @param ComponentName The name of the component in the actor
+	 * @param Type The type that the component has to be
+	 * @return The component or null if it was not found
+	 */
+	[[nodiscard]] static UActorComponent* Resolve(
+		const AActor& Actor,
+		const FName ComponentName,
+		const TSubclassOf<UActorComponent> Type);
+
+	/**
+	 * @brief Compiles the plan for a pair without caching or running it.
+	 */
+	[[nodiscard]] static FEnhancedComponentResolutionPlan Compile(
+		const UClass& ActorClass,
+		const FName ComponentName,
+		const TSubclassOf<UActorComponent> Type);
+
+	/**
+	 * @brief Goes through the components of the actor to find the one with the name (this is the slow path).
+	 */
+	[[nodiscard]] static UActorComponent* Scan(
+		const AActor& Actor,
+		const FName ComponentName,
+		const TSubclassOf<UActorComponent> Type);
+
+	/**
+	 * @brief Gets the statistics of every compiled plan, sorted so that the slowest are first.
+	 */
+	[[nodiscard]] static TArray<FEnhancedComponentPlanStatistics> GetStatistics();
+
+	static void ResetStatistics();
+
+	[[nodiscard]] static const TCHAR* LexToString(const EEnhancedComponentPlanStep Step);
+};
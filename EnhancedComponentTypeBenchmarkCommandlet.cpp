@@ -0,0 +1,143 @@
+﻿/**
+ * @file EnhancedComponentTypeBenchmarkCommandlet.cpp
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Implementation of the commandlet comparing the soft and the hard component types of the references.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#include "Utilities/Property/EnhancedComponentTypeBenchmarkCommandlet.h"
+
+#include "Utilities/Property/EnhancedComponentAssetTags.h"
+#include "Utilities/Property/EnhancedComponentReference.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/UObjectIterator.h"
+
+UEnhancedComponentTypeBenchmarkCommandlet::UEnhancedComponentTypeBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UEnhancedComponentTypeBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString SearchPath{TEXT("/Game")};
+	FParse::Value(*Params, TEXT("Path="), SearchPath);
+
+	IAssetRegistry& AssetRegistry{FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get()};
+	AssetRegistry.SearchAllAssets(true);
+
+	FARFilter Filter{};
+	Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+	Filter.bRecursiveClasses = true;
+	Filter.PackagePaths.Add(*SearchPath);
+	Filter.bRecursivePaths = true;
+	Filter.TagsAndValues.Add(FEnhancedComponentAssetTags::ReferenceCountTag, TOptional<FString>{});
+
+	TArray<FAssetData> Assets{};
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	// The tags tell which types are soft without having to load anything before measuring
+	TArray<FName> Owners{};
+	TSet<FName> SoftTypes{};
+	int32 SoftReferenceCount{0};
+	int32 ReferenceCount{0};
+
+	for (const FAssetData& Asset : Assets)
+	{
+		Owners.Push(Asset.PackageName);
+
+		for (const FEnhancedComponentReferenceTag& Tag : FEnhancedComponentAssetTags::Parse(Asset))
+		{
+			++ReferenceCount;
+			if (!Tag.bSoftType || Tag.Type.IsNull())
+			{
+				continue;
+			}
+
+			++SoftReferenceCount;
+
+			// The C++ classes are loaded with their module anyway, only the Blueprint ones can be left out
+			if (const FName Package{Tag.Type.GetLongPackageFName()}; !Package.ToString().StartsWith(TEXT("/Script/")))
+			{
+				SoftTypes.Add(Package);
+			}
+		}
+	}
+
+	UE_LOG(
+		LogEnhancedComponentReference,
+		Display,
+		TEXT("%d owners with %d references, %d of them soft (%d Blueprint types)"),
+		Owners.Num(),
+		ReferenceCount,
+		SoftReferenceCount,
+		SoftTypes.Num());
+
+	const FLoadMeasure SoftMeasure{Load(Owners)};
+
+	// Anything loaded by the owners through another path would have been loaded in both modes
+	TArray<FName> Pending{};
+	for (const FName Package : SoftTypes)
+	{
+		if (FindPackage(nullptr, *Package.ToString()) == nullptr)
+		{
+			Pending.Push(Package);
+		}
+	}
+
+	const FLoadMeasure TypesMeasure{Load(Pending)};
+
+	UE_LOG(
+		LogEnhancedComponentReference,
+		Display,
+		TEXT("Soft types: %.2f ms, %d packages"),
+		SoftMeasure.Seconds * 1000.0,
+		SoftMeasure.Packages);
+	UE_LOG(
+		LogEnhancedComponentReference,
+		Display,
+		TEXT("Hard types: %.2f ms, %d packages (%d types not already loaded by the owners)"),
+		(SoftMeasure.Seconds + TypesMeasure.Seconds) * 1000.0,
+		SoftMeasure.Packages + TypesMeasure.Packages,
+		Pending.Num());
+
+	return 0;
+}
+
+UEnhancedComponentTypeBenchmarkCommandlet::FLoadMeasure UEnhancedComponentTypeBenchmarkCommandlet::Load(
+	const TArray<FName>& PackageNames)
+{
+	const auto CountPackages{
+		[]
+		{
+			int32 Output{0};
+			for (TObjectIterator<UPackage> It{}; It; ++It)
+			{
+				++Output;
+			}
+			return Output;
+		}
+	};
+
+	const int32 PackagesBefore{CountPackages()};
+	const double Start{FPlatformTime::Seconds()};
+
+	for (const FName PackageName : PackageNames)
+	{
+		LoadPackageAsync(PackageName.ToString());
+	}
+	FlushAsyncLoading();
+
+	FLoadMeasure Output{};
+	Output.Seconds = FPlatformTime::Seconds() - Start;
+	Output.Packages = CountPackages() - PackagesBefore;
+
+	return Output;
+}
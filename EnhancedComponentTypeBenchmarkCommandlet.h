@@ -0,0 +1,46 @@
+﻿/**
+ * @file EnhancedComponentTypeBenchmarkCommandlet.h
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Commandlet measuring how much the soft component types of the references save when loading their owners.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=EnhancedComponentTypeBenchmark -nullrhi [-Path=/Game/Characters]
+ *
+ * The owners get loaded first, which is what the soft types cost, and then the types they left out, which is what
+ * loading them as hard types would add on top. Nothing can be unloaded in between, so this has to run in its own
+ * process for the numbers to mean anything.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "EnhancedComponentTypeBenchmarkCommandlet.generated.h"
+
+/**
+ * @brief Compares the load time and the loaded packages of the owners with soft and with hard component types.
+ */
+UCLASS()
+class IDOLONDUTY_API UEnhancedComponentTypeBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UEnhancedComponentTypeBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/**
+	 * @brief Time and packages taken by loading a set of packages.
+	 */
+	struct FLoadMeasure
+	{
+		double Seconds{0.0};
+		int32 Packages{0};
+	};
+
+	[[nodiscard]] static FLoadMeasure Load(const TArray<FName>& PackageNames);
+};
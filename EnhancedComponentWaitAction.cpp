@@ -0,0 +1,59 @@
+﻿/**
+ * @file EnhancedComponentWaitAction.cpp
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Implementation of the Blueprint node waiting for the component of a reference.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#include "Utilities/Property/EnhancedComponentWaitAction.h"
+
+#include "Utilities/Property/EnhancedComponentReference.h"
+#include "Utilities/Property/EnhancedComponentReferenceSubsystem.h"
+#include "Engine/World.h"
+
+UEnhancedComponentWaitAction* UEnhancedComponentWaitAction::WaitForEnhancedComponent(
+	UEnhancedComponentReference* Reference,
+	UObject* InstancedObject,
+	const float Timeout)
+{
+	UEnhancedComponentWaitAction* Output{NewObject<UEnhancedComponentWaitAction>()};
+	Output->Reference = Reference;
+	Output->InstancedObject = InstancedObject;
+	Output->Timeout = Timeout;
+	Output->RegisterWithGameInstance(InstancedObject);
+
+	return Output;
+}
+
+void UEnhancedComponentWaitAction::Activate()
+{
+	UObject* Object{InstancedObject.Get()};
+	const UWorld* World{Object != nullptr ? Object->GetWorld() : nullptr};
+	UEnhancedComponentReferenceSubsystem* Subsystem{
+		World != nullptr ? World->GetSubsystem<UEnhancedComponentReferenceSubsystem>() : nullptr
+	};
+
+	if (Reference == nullptr || Subsystem == nullptr)
+	{
+		UE_LOG(
+			LogEnhancedComponentReference,
+			Warning,
+			TEXT("There is no valid reference or owner to wait on"));
+		HandleAvailable(nullptr);
+		return;
+	}
+
+	Subsystem->AddOnComponentAvailable(
+		*Reference,
+		*Object,
+		FOnEnhancedComponentAvailable::FDelegate::CreateUObject(this, &UEnhancedComponentWaitAction::HandleAvailable),
+		Timeout);
+}
+
+void UEnhancedComponentWaitAction::HandleAvailable(UActorComponent* Component)
+{
+	Finished.Broadcast(Component);
+	SetReadyToDestroy();
+}
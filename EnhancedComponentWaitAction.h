@@ -0,0 +1,56 @@
+﻿/**
+ * @file EnhancedComponentWaitAction.h
+ * @author Edgar Jose Donoso Mansilla (e.donosomansilla)
+ *
+ * @brief Blueprint latent node waiting for the component of an enhanced component reference to show up.
+ *
+ * @copyright DigiPen Institute of Technology 2026
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "EnhancedComponentWaitAction.generated.h"
+
+class UEnhancedComponentReference;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnEnhancedComponentWaitFinished, UActorComponent*, Component);
+
+/**
+ * @brief Async node over UEnhancedComponentReferenceSubsystem::AddOnComponentAvailable.
+ */
+UCLASS()
+class IDOLONDUTY_API UEnhancedComponentWaitAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * @brief Waits until the component of the reference is on the owner.
+	 * @param Reference The reference to resolve
+	 * @param InstancedObject The owner that we should be fetching from
+	 * @param Timeout Seconds after which it finishes with null, 0 to wait for as long as the owner lives
+	 */
+	UFUNCTION(BlueprintCallable, meta=(BlueprintInternalUseOnly="true", DisplayName="Wait For Enhanced Component"))
+	static UEnhancedComponentWaitAction* WaitForEnhancedComponent(
+		UEnhancedComponentReference* Reference,
+		UObject* InstancedObject,
+		float Timeout = 0.0f);
+
+	virtual void Activate() override;
+
+	/** Called with the component, or with null if the owner got destroyed or the wait timed out before it showed up */
+	UPROPERTY(BlueprintAssignable)
+	FOnEnhancedComponentWaitFinished Finished;
+
+private:
+	void HandleAvailable(UActorComponent* Component);
+
+	UPROPERTY()
+	TObjectPtr<UEnhancedComponentReference> Reference;
+
+	TWeakObjectPtr<UObject> InstancedObject;
+
+	float Timeout{0.0f};
+};